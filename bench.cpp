@@ -0,0 +1,182 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "search.cpp"
+
+/**
+ * @brief The positions searched by the benchmarks
+ */
+const std::vector<std::string> positions = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/4k3/8/2p5/8/B2P4/5K2 w - - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N2N2/PP2BPPP/R2QKB1R w KQ - 0 8",
+};
+
+/**
+ * @brief Measures the time to reach a depth on every position with 1, 2, 4, 8,
+ * 16 and 32 threads (Lazy SMP) and the speedup over one thread
+ *
+ * @param depth The depth
+ * @param hash_mb The size of the transposition table
+ * @param max_threads The largest number of threads
+ */
+void smp_bench(int depth, size_t hash_mb, int max_threads) {
+    PlayeChessEngine::search::TranspositionTable tt(hash_mb);
+    PlayeChessEngine::search::Limits limits;
+    limits.depth = depth;
+    double single = 0;
+    std::printf("Depth %d on %zu positions, %u hardware thread(s)\n", depth, positions.size(), std::thread::hardware_concurrency());
+    std::printf("%-8s %10s %14s %12s %8s\n", "threads", "time (s)", "nodes", "nps", "speedup");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        uint64_t nodes = 0;
+        double seconds = 0;
+        for (const std::string &fen : positions) {
+            tt.clear();
+            tt.new_search();
+            PlayeChessEngine::board::Board board(fen);
+            auto start = std::chrono::steady_clock::now();
+            auto result = PlayeChessEngine::search::think_parallel(board, &tt, threads, limits);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            nodes += result.nodes;
+        }
+        if (threads == 1)
+            single = seconds;
+        std::printf("%-8d %10.3f %14llu %12.0f %7.2fx\n", threads, seconds, (unsigned long long)nodes, nodes / seconds, single / seconds);
+    }
+}
+
+/**
+ * @brief Searches every position to a depth and reports the nodes and how often
+ * the first move tried causes the cutoff (the quality of the move ordering)
+ *
+ * @param depth The depth
+ * @param hash_mb The size of the transposition table
+ */
+void ordering_bench(int depth, size_t hash_mb) {
+    PlayeChessEngine::search::TranspositionTable tt(hash_mb);
+    PlayeChessEngine::search::Limits limits;
+    limits.depth = depth;
+    uint64_t nodes = 0, cutoffs = 0, first = 0;
+    std::printf("Depth %d\n%-72s %12s %10s %8s\n", depth, "position", "nodes", "cutoffs", "first");
+    for (const std::string &fen : positions) {
+        tt.clear();
+        tt.new_search();
+        PlayeChessEngine::search::Searcher searcher(PlayeChessEngine::board::Board(fen), &tt);
+        auto result = searcher.think(limits);
+        nodes += result.nodes;
+        cutoffs += result.cutoffs;
+        first += result.first_move_cutoffs;
+        std::printf("%-72s %12llu %10llu %7.1f%%\n", fen.c_str(), (unsigned long long)result.nodes, (unsigned long long)result.cutoffs, result.cutoffs ? 100.0 * result.first_move_cutoffs / result.cutoffs : 0.0);
+    }
+    std::printf("%-72s %12llu %10llu %7.1f%%\n", "total", (unsigned long long)nodes, (unsigned long long)cutoffs, cutoffs ? 100.0 * first / cutoffs : 0.0);
+}
+
+/**
+ * @brief Measures the network evaluations per second of every kernel the CPU
+ * can run, on the positions of random games from the benchmark positions: once
+ * computing the accumulators from scratch, once following the moves (the
+ * accumulators updated by make_move, as in the search)
+ *
+ * @param path The network file
+ */
+void nnue_bench(const std::string &path) {
+    PlayeChessEngine::nnue::Network network(path);
+    std::mt19937 random(1);
+    std::vector<PlayeChessEngine::board::Board> starts;
+    std::vector<std::vector<PlayeChessEngine::board::PackedMove>> games;
+    std::vector<PlayeChessEngine::board::Board> reached;
+    for (const std::string &fen : positions) {
+        for (int g = 0; g < 8; g++) {
+            PlayeChessEngine::board::Board board(fen);
+            starts.push_back(board);
+            games.emplace_back();
+            for (int ply = 0; ply < 100; ply++) {
+                auto moves = board.generate_moves(board.is_white_turn());
+                if (moves.empty())
+                    break;
+                games.back().push_back(moves[random() % moves.size()]);
+                board.make_move(games.back().back());
+                reached.push_back(board);
+            }
+        }
+    }
+    const int rounds = 20;
+    std::printf("%zu positions, %d rounds\n%-8s %16s %16s %12s\n", reached.size(), rounds, "kernel", "refresh/s", "incremental/s", "checksum");
+    for (const PlayeChessEngine::nnue::Kernel *kernel : PlayeChessEngine::nnue::available_kernels()) {
+        PlayeChessEngine::nnue::Evaluator evaluator(network, kernel);
+        int64_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (const auto &board : reached) {
+                evaluator.reset(board);
+                checksum += evaluator.evaluate(board);
+            }
+        }
+        double refresh = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (size_t g = 0; g < games.size(); g++) {
+                PlayeChessEngine::board::Board &board = starts[g];
+                std::vector<PlayeChessEngine::board::UndoInfo> undos;
+                evaluator.reset(board);
+                for (auto move : games[g]) {
+                    undos.push_back(board.make_move(move));
+                    evaluator.push(board, undos.back());
+                    checksum -= evaluator.evaluate(board);
+                }
+                for (size_t i = undos.size(); i-- > 0;) {
+                    board.unmake_move(undos[i]);
+                    evaluator.pop();
+                }
+            }
+        }
+        double incremental = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double evaluations = double(reached.size()) * rounds;
+        // Both loops evaluate the same positions, so a kernel that is right gives 0
+        std::printf("%-8s %16.0f %16.0f %12lld\n", kernel->name, evaluations / refresh, evaluations / incremental, (long long)checksum);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> args;
+    size_t hash_mb = 64;
+    int max_threads = 32;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--hash" && i + 1 < argc)
+            hash_mb = std::stoul(argv[++i]);
+        else if (arg == "--max-threads" && i + 1 < argc)
+            max_threads = std::max(1, std::stoi(argv[++i]));
+        else
+            args.push_back(arg);
+    }
+    if (!args.empty() && args[0] == "--smp") {
+        smp_bench(args.size() > 1 ? std::stoi(args[1]) : 6, hash_mb, max_threads);
+        return 0;
+    }
+    if (!args.empty() && args[0] == "--ordering") {
+        ordering_bench(args.size() > 1 ? std::stoi(args[1]) : 7, hash_mb);
+        return 0;
+    }
+    if (args.size() > 1 && args[0] == "--nnue") {
+        nnue_bench(args[1]);
+        return 0;
+    }
+    if (args.size() > 1 && args[0] == "--nnue-random") {
+        PlayeChessEngine::nnue::Network::write_random(args[1]);
+        return 0;
+    }
+    std::cout << "Usage: bench --smp [depth] [--hash mb] [--max-threads n] | bench --ordering [depth] [--hash mb] | bench --nnue <file> | bench --nnue-random <file>" << std::endl;
+    return 1;
+}
@@ -0,0 +1,380 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "pce.cpp"
+
+namespace PlayeChessEngine {
+	/**
+	 * @brief The kinds of requests a GameHost processes
+	 */
+	enum request_type { new_game, play_move, legal_moves, game_status, close_game };
+
+	/**
+	 * @brief Gets the name of a result
+	 *
+	 * @param result The result
+	 * @return The name (e.g. checkmate, fifty_moves) (const char*)
+	 */
+	const char *result_name(GameResult result) {
+		switch (result) {
+			case GameResult::checkmate:
+				return "checkmate";
+			case GameResult::stalemate:
+				return "stalemate";
+			case GameResult::fifty_moves:
+				return "fifty_moves";
+			case GameResult::repetition:
+				return "repetition";
+			case GameResult::insufficient_material:
+				return "insufficient_material";
+			default:
+				return "ongoing";
+		}
+	}
+
+	/**
+	 * @brief A request sent to a GameHost
+	 */
+	struct HostRequest {
+		/**
+		 * @brief A number chosen by the caller, copied to the response
+		 */
+		uint64_t tag = 0;
+		/**
+		 * @brief The game (refer to GameHost::create_game_id)
+		 */
+		uint32_t game = 0;
+		/**
+		 * @brief The kind of request (refer to the request_type enum)
+		 */
+		request_type type = play_move;
+		/**
+		 * @brief The fen for new_game (empty for the initial position), the move for
+		 * play_move (e.g. e2e4, e7e8q)
+		 */
+		std::string argument;
+		/**
+		 * @brief When the request was submitted (set by GameHost::submit)
+		 */
+		std::chrono::steady_clock::time_point submitted;
+	};
+
+	/**
+	 * @brief The response of a GameHost to a request
+	 */
+	struct HostResponse {
+		/**
+		 * @brief The tag of the request
+		 */
+		uint64_t tag = 0;
+		/**
+		 * @brief The game of the request
+		 */
+		uint32_t game = 0;
+		/**
+		 * @brief The kind of request
+		 */
+		request_type type = play_move;
+		/**
+		 * @brief If the request succeeded (false for an illegal move, an unknown game
+		 * or an invalid fen)
+		 */
+		bool ok = false;
+		/**
+		 * @brief The result of the game after the request
+		 */
+		GameResult result = GameResult::ongoing;
+		/**
+		 * @brief If it is white's turn after the request
+		 */
+		bool white_turn = true;
+		/**
+		 * @brief The legal moves separated by spaces (legal_moves), the fen
+		 * (game_status) or the error
+		 */
+		std::string data;
+		/**
+		 * @brief The time from the submission to the end of the processing (in
+		 * microseconds)
+		 */
+		double latency_us = 0;
+	};
+
+	/**
+	 * @brief Hosts many independent games and processes their requests on a fixed
+	 * pool of workers (every game belongs to one worker, so the games need no lock,
+	 * only the queues are locked once per batch)
+	 *
+	 */
+	class GameHost {
+		private:
+			/**
+			 * @brief A worker thread with its queue and its games
+			 */
+			struct Worker {
+				/**
+				 * @brief The thread
+				 */
+				std::thread thread;
+				/**
+				 * @brief The lock of the queue
+				 */
+				std::mutex mutex;
+				/**
+				 * @brief Signaled when requests are queued
+				 */
+				std::condition_variable ready;
+				/**
+				 * @brief The requests waiting to be processed
+				 */
+				std::vector<HostRequest> queue;
+				/**
+				 * @brief The games of this worker (only used by the worker thread)
+				 */
+				std::unordered_map<uint32_t, GameSession> games;
+			};
+
+			/**
+			 * @brief The workers
+			 */
+			std::vector<std::unique_ptr<Worker>> workers;
+			/**
+			 * @brief The requests of the batch being submitted, by worker
+			 */
+			std::vector<std::vector<HostRequest>> buckets;
+			/**
+			 * @brief The lock of the completed responses
+			 */
+			std::mutex completed_mutex;
+			/**
+			 * @brief Signaled when responses are completed
+			 */
+			std::condition_variable completed_ready;
+			/**
+			 * @brief The responses waiting to be collected
+			 */
+			std::vector<HostResponse> completed;
+			/**
+			 * @brief Called by the workers once responses are completed (e.g. to wake an
+			 * event loop)
+			 */
+			std::function<void()> notify;
+			/**
+			 * @brief The next game id
+			 */
+			std::atomic<uint32_t> next_game{1};
+			/**
+			 * @brief If the workers should stop (once their queue is empty, read by every
+			 * worker under its own mutex)
+			 */
+			std::atomic<bool> stopping{false};
+
+			/**
+			 * @brief Processes the requests of a worker until the host stops
+			 *
+			 * @param worker The worker
+			 */
+			void run(Worker &worker) {
+				std::vector<HostRequest> batch;
+				std::vector<HostResponse> done;
+				while (true) {
+					{
+						std::unique_lock<std::mutex> lock(worker.mutex);
+						worker.ready.wait(lock, [&]() { return this->stopping || !worker.queue.empty(); });
+						if (worker.queue.empty())
+							return;
+						batch.swap(worker.queue);
+					}
+					for (HostRequest &request : batch)
+						done.push_back(this->process(worker, request));
+					batch.clear();
+					{
+						std::lock_guard<std::mutex> lock(this->completed_mutex);
+						for (HostResponse &response : done)
+							this->completed.push_back(std::move(response));
+					}
+					this->completed_ready.notify_all();
+					if (this->notify)
+						this->notify();
+					done.clear();
+				}
+			}
+
+			/**
+			 * @brief Processes a request on the games of a worker
+			 *
+			 * @param worker The worker owning the game
+			 * @param request The request
+			 * @return The response (HostResponse)
+			 */
+			HostResponse process(Worker &worker, HostRequest &request) {
+				HostResponse response;
+				response.tag = request.tag;
+				response.game = request.game;
+				response.type = request.type;
+				if (request.type == new_game) {
+					try {
+						GameSession session = request.argument.empty() ? GameSession() : GameSession(request.argument);
+						worker.games.insert_or_assign(request.game, std::move(session));
+						response.ok = true;
+					} catch (const std::invalid_argument &error) {
+						response.data = error.what();
+					}
+				}
+				auto game = worker.games.find(request.game);
+				if (game == worker.games.end()) {
+					if (request.type != new_game)
+						response.data = "unknown game";
+					return this->finish(response, request);
+				}
+				GameSession &session = game->second;
+				switch (request.type) {
+					case play_move:
+						response.ok = session.apply_move(request.argument);
+						if (!response.ok)
+							response.data = "illegal move";
+						break;
+					case legal_moves:
+						for (auto move : session.legal_moves()) {
+							if (!response.data.empty())
+								response.data += ' ';
+							response.data += move.notation();
+						}
+						response.ok = true;
+						break;
+					case game_status:
+						response.data = session.fen();
+						response.ok = true;
+						break;
+					case close_game:
+						worker.games.erase(game);
+						response.ok = true;
+						return this->finish(response, request);
+					default:
+						break;
+				}
+				response.result = session.result();
+				response.white_turn = session.is_white_turn();
+				return this->finish(response, request);
+			}
+
+			/**
+			 * @brief Sets the latency of a response
+			 *
+			 * @param response The response
+			 * @param request The request
+			 * @return The response (HostResponse)
+			 */
+			static HostResponse &finish(HostResponse &response, const HostRequest &request) {
+				response.latency_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - request.submitted).count();
+				return response;
+			}
+
+		public:
+			/**
+			 * @brief Construct a new GameHost object
+			 *
+			 * @param threads The number of workers (at least 1)
+			 * @param notify Called by the workers once responses are completed (optional)
+			 */
+			GameHost(int threads, std::function<void()> notify = nullptr) : notify(std::move(notify)) {
+				threads = std::max(1, threads);
+				this->buckets.resize(threads);
+				for (int i = 0; i < threads; i++)
+					this->workers.emplace_back(new Worker());
+				for (auto &worker : this->workers) {
+					Worker *owned = worker.get();
+					worker->thread = std::thread([this, owned]() { this->run(*owned); });
+				}
+			}
+
+			GameHost(const GameHost &) = delete;
+			GameHost &operator=(const GameHost &) = delete;
+
+			/**
+			 * @brief Destroy the GameHost object (the queued requests are processed
+			 * first)
+			 */
+			~GameHost() {
+				this->stopping = true;
+				// Taking each mutex once makes sure no worker is between its check and its
+				// wait when it is notified
+				for (auto &worker : this->workers)
+					std::lock_guard<std::mutex> lock(worker->mutex);
+				for (auto &worker : this->workers) {
+					worker->ready.notify_all();
+					worker->thread.join();
+				}
+			}
+
+			/**
+			 * @brief Gets a new game id (thread safe)
+			 *
+			 * @return The id (uint32_t)
+			 */
+			uint32_t create_game_id() {
+				return this->next_game++;
+			}
+
+			/**
+			 * @brief Gets the number of workers
+			 *
+			 * @return The number of workers (int)
+			 */
+			int get_threads() const {
+				return int(this->workers.size());
+			}
+
+			/**
+			 * @brief Queues a batch of requests (each queue is locked once, the requests of
+			 * a game are processed in order). Submit from one thread at a time.
+			 *
+			 * @param requests The requests (emptied)
+			 */
+			void submit(std::vector<HostRequest> &requests) {
+				auto now = std::chrono::steady_clock::now();
+				for (HostRequest &request : requests) {
+					request.submitted = now;
+					this->buckets[request.game % this->workers.size()].push_back(std::move(request));
+				}
+				requests.clear();
+				for (size_t i = 0; i < this->workers.size(); i++) {
+					if (this->buckets[i].empty())
+						continue;
+					{
+						std::lock_guard<std::mutex> lock(this->workers[i]->mutex);
+						for (HostRequest &request : this->buckets[i])
+							this->workers[i]->queue.push_back(std::move(request));
+					}
+					this->workers[i]->ready.notify_one();
+					this->buckets[i].clear();
+				}
+			}
+
+			/**
+			 * @brief Collects the completed responses
+			 *
+			 * @param responses The vector to append the responses to
+			 * @param wait If the call should wait for at least one response
+			 * @return The number of responses collected (size_t)
+			 */
+			size_t complete(std::vector<HostResponse> &responses, bool wait = true) {
+				std::unique_lock<std::mutex> lock(this->completed_mutex);
+				if (wait)
+					this->completed_ready.wait(lock, [&]() { return !this->completed.empty(); });
+				size_t count = this->completed.size();
+				for (HostResponse &response : this->completed)
+					responses.push_back(std::move(response));
+				this->completed.clear();
+				return count;
+			}
+	};
+} // namespace PlayeChessEngine
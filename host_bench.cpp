@@ -0,0 +1,155 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "game_host.cpp"
+
+/**
+ * @brief The moves of a random game, played again by the host
+ */
+struct Script {
+    uint32_t game = 0;
+    std::vector<std::string> moves;
+};
+
+/**
+ * @brief Plays random legal games to feed the host
+ *
+ * @param count The number of games
+ * @param length The maximum number of plies of a game
+ * @param seed The seed of the random moves
+ * @return The games (std::vector<Script>)
+ */
+std::vector<Script> random_scripts(int count, int length, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<Script> scripts(count);
+    for (Script &script : scripts) {
+        PlayeChessEngine::GameSession session;
+        for (int ply = 0; ply < length && session.result() == PlayeChessEngine::GameResult::ongoing; ply++) {
+            auto moves = session.legal_moves();
+            auto move = moves[random() % moves.size()];
+            script.moves.push_back(move.notation());
+            session.apply_move(move);
+        }
+    }
+    return scripts;
+}
+
+/**
+ * @brief Gets a percentile of sorted values
+ *
+ * @param sorted The values (sorted)
+ * @param percentile The percentile (0 to 100)
+ * @return The value (double)
+ */
+double percentile(const std::vector<double> &sorted, double percentile) {
+    if (sorted.empty())
+        return 0;
+    size_t index = size_t(percentile / 100 * double(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * @brief Plays the games on a host, move by move for all the games at once
+ * (every round is submitted in batches) and reports the throughput and latency
+ *
+ * @param scripts The games
+ * @param threads The number of workers
+ * @param batch The number of requests per submission
+ * @param window The maximum number of requests in flight
+ * @return If every move was accepted (bool)
+ */
+bool run(std::vector<Script> &scripts, int threads, size_t batch, size_t window) {
+    PlayeChessEngine::GameHost host(threads);
+    std::vector<PlayeChessEngine::HostRequest> requests;
+    std::vector<PlayeChessEngine::HostResponse> responses;
+    std::vector<double> latencies;
+    size_t rejected = 0, moves = 0, longest = 0;
+
+    auto submit_all = [&](size_t expected) {
+        size_t received = 0;
+        for (size_t i = 0; i < requests.size();) {
+            std::vector<PlayeChessEngine::HostRequest> chunk;
+            for (size_t end = std::min(requests.size(), i + batch); i < end; i++)
+                chunk.push_back(std::move(requests[i]));
+            host.submit(chunk);
+            received += host.complete(responses, false);
+            while (i - received > window)
+                received += host.complete(responses);
+        }
+        requests.clear();
+        while (received < expected)
+            received += host.complete(responses);
+        for (auto &response : responses) {
+            if (!response.ok)
+                rejected++;
+            if (response.type == PlayeChessEngine::play_move)
+                latencies.push_back(response.latency_us);
+        }
+        responses.clear();
+    };
+
+    for (Script &script : scripts) {
+        script.game = host.create_game_id();
+        longest = std::max(longest, script.moves.size());
+        PlayeChessEngine::HostRequest request;
+        request.game = script.game;
+        request.type = PlayeChessEngine::new_game;
+        requests.push_back(request);
+    }
+    submit_all(scripts.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t ply = 0; ply < longest; ply++) {
+        size_t expected = 0;
+        for (Script &script : scripts) {
+            if (ply >= script.moves.size())
+                continue;
+            PlayeChessEngine::HostRequest request;
+            request.tag = ply;
+            request.game = script.game;
+            request.type = PlayeChessEngine::play_move;
+            request.argument = script.moves[ply];
+            requests.push_back(std::move(request));
+            expected++;
+        }
+        moves += expected;
+        submit_all(expected);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%zu games, %zu moves, %d thread(s), batches of %zu, window of %zu\n", scripts.size(), moves, threads, batch, window);
+    std::printf("%.0f moves/s (%.0f per thread) in %.3f s\n", moves / seconds, moves / seconds / threads, seconds);
+    std::printf("latency p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n", percentile(latencies, 50), percentile(latencies, 99), percentile(latencies, 99.9), latencies.empty() ? 0.0 : latencies.back());
+    std::printf("%zu rejected\n", rejected);
+    return rejected == 0;
+}
+
+int main(int argc, char *argv[]) {
+    int games = 10000, threads = std::max(1u, std::thread::hardware_concurrency()), length = 80;
+    size_t batch = 256, window = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--games")
+            games = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--threads")
+            threads = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--moves")
+            length = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--batch")
+            batch = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--window")
+            window = std::stoul(argv[i + 1]);
+        else {
+            std::cout << "Usage: host_bench [--games n] [--threads n] [--moves n] [--batch n] [--window n]" << std::endl;
+            return 1;
+        }
+    }
+    std::vector<Script> scripts = random_scripts(games, length, 1);
+    return run(scripts, threads, batch, std::max(window, batch * threads * 2)) ? 0 : 1;
+}
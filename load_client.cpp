@@ -0,0 +1,272 @@
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "pce.cpp"
+
+/**
+ * @brief A connection of the load generator, playing several games at once
+ * (every round creates the games, plays their moves interleaved and closes them)
+ */
+struct Client {
+    int fd = -1;
+    /**
+     * @brief The games of the round (the script of each game, then its id once
+     * created)
+     */
+    std::vector<size_t> scripts;
+    std::vector<uint32_t> games;
+    /**
+     * @brief The requests of the round once the games are created
+     */
+    std::vector<std::string> plan;
+    size_t planned = 0;
+    int round = 0;
+    /**
+     * @brief The send time of each request in flight (the responses come in order)
+     */
+    std::deque<std::chrono::steady_clock::time_point> in_flight;
+    std::string input;
+    std::string output;
+    bool done = false;
+};
+
+/**
+ * @brief Plays random legal games to get moves to send
+ *
+ * @param count The number of games
+ * @param length The maximum number of plies of a game
+ * @return The moves of each game (std::vector<std::vector<std::string>>)
+ */
+std::vector<std::vector<std::string>> random_scripts(int count, int length) {
+    std::mt19937 random(1);
+    std::vector<std::vector<std::string>> scripts(count);
+    for (auto &script : scripts) {
+        PlayeChessEngine::GameSession session;
+        for (int ply = 0; ply < length && session.result() == PlayeChessEngine::GameResult::ongoing; ply++) {
+            auto moves = session.legal_moves();
+            auto move = moves[random() % moves.size()];
+            script.push_back(move.notation());
+            session.apply_move(move);
+        }
+    }
+    return scripts;
+}
+
+/**
+ * @brief Gets a percentile of sorted values
+ *
+ * @param sorted The values (sorted)
+ * @param percentile The percentile (0 to 100)
+ * @return The value (double)
+ */
+double percentile(const std::vector<double> &sorted, double percentile) {
+    if (sorted.empty())
+        return 0;
+    size_t index = size_t(percentile / 100 * double(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * @brief Connects to the server
+ *
+ * @param port The TCP port on the loopback interface (if path is empty)
+ * @param path The path of the Unix socket
+ * @return The socket (-1 on error) (int)
+ */
+int connect_to(int port, const std::string &path) {
+    int fd;
+    if (path.empty()) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(uint16_t(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (sockaddr *)&address, sizeof(address)) != 0)
+            return close(fd), -1;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (connect(fd, (sockaddr *)&address, sizeof(address)) != 0)
+            return close(fd), -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+    int port = 7878, connections = 8, games = 32, rounds = 10, length = 80;
+    size_t depth = 64;
+    std::string path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--port")
+            port = std::stoi(argv[i + 1]);
+        else if (arg == "--unix")
+            path = argv[i + 1];
+        else if (arg == "--connections")
+            connections = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--games")
+            games = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--rounds")
+            rounds = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--moves")
+            length = std::max(1, std::stoi(argv[i + 1]));
+        else if (arg == "--depth")
+            depth = std::max(1, std::stoi(argv[i + 1]));
+        else {
+            std::cout << "Usage: load_client [--port n | --unix path] [--connections n] [--games n] [--rounds n] [--moves n] [--depth n]" << std::endl;
+            return 1;
+        }
+    }
+    auto scripts = random_scripts(256, length);
+    std::vector<Client> clients(connections);
+    int epoll_fd = epoll_create1(0);
+    for (int i = 0; i < connections; i++) {
+        Client &client = clients[i];
+        if ((client.fd = connect_to(port, path)) < 0) {
+            std::cerr << "Cannot connect: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = uint32_t(i);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event);
+    }
+
+    std::vector<double> latencies;
+    size_t requests = 0, errors = 0;
+    int finished = 0;
+
+    // Plans the "new" requests of a round (the moves are planned once the games exist)
+    auto start_round = [&](Client &client, size_t index) {
+        client.scripts.clear();
+        client.games.clear();
+        client.plan.clear();
+        client.planned = 0;
+        for (int g = 0; g < games; g++) {
+            client.scripts.push_back((index * games + g + size_t(client.round) * 7) % scripts.size());
+            client.plan.push_back("new");
+        }
+    };
+    // Plans the moves of the games interleaved, then their close
+    auto plan_moves = [&](Client &client) {
+        client.plan.clear();
+        client.planned = 0;
+        for (size_t ply = 0;; ply++) {
+            bool any = false;
+            for (size_t g = 0; g < client.games.size(); g++) {
+                auto &script = scripts[client.scripts[g]];
+                if (ply < script.size()) {
+                    client.plan.push_back("move " + std::to_string(client.games[g]) + " " + script[ply]);
+                    any = true;
+                }
+            }
+            if (!any)
+                break;
+        }
+        for (uint32_t game : client.games)
+            client.plan.push_back("close " + std::to_string(game));
+    };
+    // Sends the planned requests while there is room in the pipeline
+    auto fill = [&](Client &client) {
+        auto now = std::chrono::steady_clock::now();
+        while (client.planned < client.plan.size() && client.in_flight.size() < depth) {
+            client.output += client.plan[client.planned++];
+            client.output += '\n';
+            client.in_flight.push_back(now);
+        }
+        size_t written = 0;
+        while (written < client.output.size()) {
+            ssize_t count = send(client.fd, client.output.data() + written, client.output.size() - written, MSG_NOSIGNAL);
+            if (count <= 0)
+                break;
+            written += size_t(count);
+        }
+        client.output.erase(0, written);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < connections; i++) {
+        start_round(clients[i], size_t(i));
+        fill(clients[i]);
+    }
+    std::vector<epoll_event> events(64);
+    char buffer[65536];
+    while (finished < connections) {
+        int count = epoll_wait(epoll_fd, events.data(), int(events.size()), 1000);
+        if (count == 0) {
+            std::cerr << "Timed out waiting for the server" << std::endl;
+            return 1;
+        }
+        for (int e = 0; e < count; e++) {
+            size_t index = events[e].data.u32;
+            Client &client = clients[index];
+            if (client.done)
+                continue;
+            ssize_t received;
+            while ((received = recv(client.fd, buffer, sizeof(buffer), 0)) > 0)
+                client.input.append(buffer, size_t(received));
+            if (received == 0) {
+                std::cerr << "The server closed the connection" << std::endl;
+                return 1;
+            }
+            auto now = std::chrono::steady_clock::now();
+            size_t begin = 0;
+            for (size_t end; (end = client.input.find('\n', begin)) != std::string::npos; begin = end + 1) {
+                std::string_view line(client.input.data() + begin, end - begin);
+                latencies.push_back(std::chrono::duration<double, std::micro>(now - client.in_flight.front()).count());
+                client.in_flight.pop_front();
+                requests++;
+                if (line.substr(0, 2) != "ok") {
+                    if (errors++ < 5)
+                        std::cerr << "Error: " << line << std::endl;
+                } else if (client.games.size() < client.scripts.size() && client.plan[0] == "new")
+                    client.games.push_back(uint32_t(std::stoul(std::string(line.substr(3)))));
+            }
+            client.input.erase(0, begin);
+            if (client.planned == client.plan.size() && client.in_flight.empty()) {
+                if (!client.plan.empty() && client.plan[0] == "new")
+                    plan_moves(client);
+                else if (++client.round < rounds)
+                    start_round(client, index);
+                else {
+                    client.done = true;
+                    finished++;
+                    continue;
+                }
+            }
+            fill(client);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%d connection(s), pipeline depth %zu, %zu requests in %.3f s\n", connections, depth, requests, seconds);
+    std::printf("%.0f requests/s\n", requests / seconds);
+    std::printf("latency p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n", percentile(latencies, 50), percentile(latencies, 90), percentile(latencies, 99), percentile(latencies, 99.9), latencies.empty() ? 0.0 : latencies.back());
+    std::printf("%zu error(s)\n", errors);
+    for (Client &client : clients)
+        close(client.fd);
+    return errors == 0 ? 0 : 1;
+}
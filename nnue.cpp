@@ -0,0 +1,583 @@
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pce.cpp"
+
+namespace PlayeChessEngine {
+	/**
+	 * @brief Namespace for the efficiently updatable neural network evaluation
+	 * (NNUE): HalfKP features (king square x piece x square, from each side's point
+	 * of view) feeding two accumulators of half_dimensions int16 values, updated
+	 * with the pieces that moved, then three small int8 layers
+	 */
+	namespace nnue {
+		/**
+		 * @brief The number of input features of one side (own king square x 10 kinds
+		 * of pieces, kings excluded, x square)
+		 */
+		constexpr int features = 64 * 10 * 64;
+		/**
+		 * @brief The size of the accumulator of one side
+		 */
+		constexpr int half_dimensions = 256;
+		/**
+		 * @brief The size of the two hidden layers
+		 */
+		constexpr int hidden_dimensions = 32;
+		/**
+		 * @brief The hidden layers are divided by 2^weight_shift before their clipped
+		 * ReLU (the weights are scaled by 64)
+		 */
+		constexpr int weight_shift = 6;
+		/**
+		 * @brief The output is divided by this to get centipawns
+		 */
+		constexpr int output_scale = 16;
+		/**
+		 * @brief The version of the network file format
+		 */
+		constexpr uint32_t file_version = 1;
+
+		/**
+		 * @brief The first bytes of a network file
+		 */
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t features;
+			uint32_t half_dimensions;
+			uint32_t hidden_dimensions;
+		};
+
+		/**
+		 * @brief The offsets of the parameters in a network file (every block starts
+		 * on a cache line, so the mapped file is used in place by the SIMD kernels)
+		 */
+		struct Layout {
+			size_t feature_biases = 0, feature_weights = 0;
+			size_t hidden1_biases = 0, hidden1_weights = 0;
+			size_t hidden2_biases = 0, hidden2_weights = 0;
+			size_t output_bias = 0, output_weights = 0;
+			/**
+			 * @brief The size of the file
+			 */
+			size_t size = 0;
+
+			/**
+			 * @brief Construct the layout (at compile time)
+			 */
+			constexpr Layout() {
+				size_t offset = 64;
+				auto block = [&offset](size_t bytes) {
+					size_t start = offset;
+					offset += (bytes + 63) / 64 * 64;
+					return start;
+				};
+				this->feature_biases = block(sizeof(int16_t) * half_dimensions);
+				this->feature_weights = block(sizeof(int16_t) * half_dimensions * features);
+				this->hidden1_biases = block(sizeof(int32_t) * hidden_dimensions);
+				this->hidden1_weights = block(2 * half_dimensions * hidden_dimensions);
+				this->hidden2_biases = block(sizeof(int32_t) * hidden_dimensions);
+				this->hidden2_weights = block(hidden_dimensions * hidden_dimensions);
+				this->output_bias = block(sizeof(int32_t));
+				this->output_weights = block(hidden_dimensions);
+				this->size = offset;
+			}
+		};
+
+		/**
+		 * @brief The layout of the network files
+		 */
+		inline constexpr Layout layout;
+
+		/**
+		 * @brief Gets the feature of a piece seen by a side
+		 *
+		 * @param white The side (the board is flipped for black)
+		 * @param king The square of the king of the side
+		 * @param code The piece (mailbox code, not a king)
+		 * @param sq The square of the piece
+		 * @return The index of the feature (int)
+		 */
+		inline int feature_index(bool white, int king, int code, int sq) {
+			int flip = white ? 0 : 56;
+			int kind = (code % 6) * 2 + ((code < 6) != white);
+			return ((king ^ flip) * 10 + kind) * 64 + (sq ^ flip);
+		}
+
+		/**
+		 * @brief The operations of the evaluation that are worth vectorizing, for one
+		 * instruction set
+		 */
+		struct Kernel {
+			/**
+			 * @brief The name of the instruction set
+			 */
+			const char *name;
+			/**
+			 * @brief Computes an accumulator from another one and the weights of the
+			 * features added and removed (output = input + added - removed)
+			 */
+			void (*update)(int16_t *output, const int16_t *input, const int16_t *const *added, int added_count, const int16_t *const *removed, int removed_count);
+			/**
+			 * @brief Applies the clipped ReLU (0 to 127) to an accumulator
+			 */
+			void (*activate)(const int16_t *input, uint8_t *output);
+			/**
+			 * @brief Computes a layer (output = biases + weights x input, the weights row
+			 * by row, the input size a multiple of 32)
+			 */
+			void (*affine)(const uint8_t *input, int input_size, const int8_t *weights, const int32_t *biases, int32_t *output, int output_size);
+		};
+
+		/**
+		 * @brief The portable kernel
+		 */
+		namespace scalar {
+			inline void update(int16_t *output, const int16_t *input, const int16_t *const *added, int added_count, const int16_t *const *removed, int removed_count) {
+				for (int i = 0; i < half_dimensions; i++) {
+					int16_t value = input[i];
+					for (int a = 0; a < added_count; a++)
+						value = int16_t(value + added[a][i]);
+					for (int r = 0; r < removed_count; r++)
+						value = int16_t(value - removed[r][i]);
+					output[i] = value;
+				}
+			}
+
+			inline void activate(const int16_t *input, uint8_t *output) {
+				for (int i = 0; i < half_dimensions; i++)
+					output[i] = uint8_t(std::clamp<int>(input[i], 0, 127));
+			}
+
+			inline void affine(const uint8_t *input, int input_size, const int8_t *weights, const int32_t *biases, int32_t *output, int output_size) {
+				for (int o = 0; o < output_size; o++) {
+					int32_t sum = biases[o];
+					for (int i = 0; i < input_size; i++)
+						sum += input[i] * weights[o * input_size + i];
+					output[o] = sum;
+				}
+			}
+		} // namespace scalar
+
+#if defined(__x86_64__)
+		/**
+		 * @brief The SSE4.1 kernel (8 accumulator values per register)
+		 */
+		namespace sse41 {
+			__attribute__((target("sse4.1"))) inline void update(int16_t *output, const int16_t *input, const int16_t *const *added, int added_count, const int16_t *const *removed, int removed_count) {
+				// 64 values at a time, so that the sums stay in registers
+				for (int chunk = 0; chunk < half_dimensions; chunk += 64) {
+					__m128i sums[8];
+					for (int j = 0; j < 8; j++)
+						sums[j] = _mm_loadu_si128((const __m128i *)(input + chunk + j * 8));
+					for (int a = 0; a < added_count; a++)
+						for (int j = 0; j < 8; j++)
+							sums[j] = _mm_add_epi16(sums[j], _mm_loadu_si128((const __m128i *)(added[a] + chunk + j * 8)));
+					for (int r = 0; r < removed_count; r++)
+						for (int j = 0; j < 8; j++)
+							sums[j] = _mm_sub_epi16(sums[j], _mm_loadu_si128((const __m128i *)(removed[r] + chunk + j * 8)));
+					for (int j = 0; j < 8; j++)
+						_mm_storeu_si128((__m128i *)(output + chunk + j * 8), sums[j]);
+				}
+			}
+
+			__attribute__((target("sse4.1"))) inline void activate(const int16_t *input, uint8_t *output) {
+				const __m128i zero = _mm_setzero_si128();
+				for (int i = 0; i < half_dimensions; i += 16) {
+					__m128i packed = _mm_packs_epi16(_mm_loadu_si128((const __m128i *)(input + i)), _mm_loadu_si128((const __m128i *)(input + i + 8)));
+					_mm_storeu_si128((__m128i *)(output + i), _mm_max_epi8(packed, zero));
+				}
+			}
+
+			__attribute__((target("sse4.1"))) inline void affine(const uint8_t *input, int input_size, const int8_t *weights, const int32_t *biases, int32_t *output, int output_size) {
+				const __m128i ones = _mm_set1_epi16(1);
+				for (int o = 0; o < output_size; o++) {
+					const int8_t *row = weights + o * input_size;
+					__m128i sum = _mm_setzero_si128();
+					for (int i = 0; i < input_size; i += 16) {
+						__m128i products = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)(input + i)), _mm_loadu_si128((const __m128i *)(row + i)));
+						sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+					}
+					sum = _mm_hadd_epi32(sum, sum);
+					sum = _mm_hadd_epi32(sum, sum);
+					output[o] = biases[o] + _mm_cvtsi128_si32(sum);
+				}
+			}
+		} // namespace sse41
+
+		/**
+		 * @brief The AVX2 kernel (16 accumulator values per register)
+		 */
+		namespace avx2 {
+			__attribute__((target("avx2"))) inline void update(int16_t *output, const int16_t *input, const int16_t *const *added, int added_count, const int16_t *const *removed, int removed_count) {
+				// 128 values at a time, so that the sums stay in registers
+				for (int chunk = 0; chunk < half_dimensions; chunk += 128) {
+					__m256i sums[8];
+					for (int j = 0; j < 8; j++)
+						sums[j] = _mm256_loadu_si256((const __m256i *)(input + chunk + j * 16));
+					for (int a = 0; a < added_count; a++)
+						for (int j = 0; j < 8; j++)
+							sums[j] = _mm256_add_epi16(sums[j], _mm256_loadu_si256((const __m256i *)(added[a] + chunk + j * 16)));
+					for (int r = 0; r < removed_count; r++)
+						for (int j = 0; j < 8; j++)
+							sums[j] = _mm256_sub_epi16(sums[j], _mm256_loadu_si256((const __m256i *)(removed[r] + chunk + j * 16)));
+					for (int j = 0; j < 8; j++)
+						_mm256_storeu_si256((__m256i *)(output + chunk + j * 16), sums[j]);
+				}
+			}
+
+			__attribute__((target("avx2"))) inline void activate(const int16_t *input, uint8_t *output) {
+				const __m256i zero = _mm256_setzero_si256();
+				for (int i = 0; i < half_dimensions; i += 32) {
+					__m256i packed = _mm256_packs_epi16(_mm256_loadu_si256((const __m256i *)(input + i)), _mm256_loadu_si256((const __m256i *)(input + i + 16)));
+					// The pack works on each half of the registers: put the values back in order
+					packed = _mm256_permute4x64_epi64(packed, 0xD8);
+					_mm256_storeu_si256((__m256i *)(output + i), _mm256_max_epi8(packed, zero));
+				}
+			}
+
+			__attribute__((target("avx2"))) inline void affine(const uint8_t *input, int input_size, const int8_t *weights, const int32_t *biases, int32_t *output, int output_size) {
+				const __m256i ones = _mm256_set1_epi16(1);
+				for (int o = 0; o < output_size; o++) {
+					const int8_t *row = weights + o * input_size;
+					__m256i sum = _mm256_setzero_si256();
+					for (int i = 0; i < input_size; i += 32) {
+						__m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i *)(input + i)), _mm256_loadu_si256((const __m256i *)(row + i)));
+						sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+					}
+					__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+					half = _mm_hadd_epi32(half, half);
+					half = _mm_hadd_epi32(half, half);
+					output[o] = biases[o] + _mm_cvtsi128_si32(half);
+				}
+			}
+		} // namespace avx2
+#endif
+
+		/**
+		 * @brief The kernels, fastest first
+		 */
+		inline const Kernel scalar_kernel = {"scalar", scalar::update, scalar::activate, scalar::affine};
+#if defined(__x86_64__)
+		inline const Kernel sse41_kernel = {"sse4.1", sse41::update, sse41::activate, sse41::affine};
+		inline const Kernel avx2_kernel = {"avx2", avx2::update, avx2::activate, avx2::affine};
+#endif
+
+		/**
+		 * @brief Gets the kernels the CPU can run
+		 *
+		 * @return The kernels, fastest first (std::vector<const Kernel *>)
+		 */
+		inline std::vector<const Kernel *> available_kernels() {
+			std::vector<const Kernel *> kernels;
+#if defined(__x86_64__)
+			if (__builtin_cpu_supports("avx2"))
+				kernels.push_back(&avx2_kernel);
+			if (__builtin_cpu_supports("sse4.1"))
+				kernels.push_back(&sse41_kernel);
+#endif
+			kernels.push_back(&scalar_kernel);
+			return kernels;
+		}
+
+		/**
+		 * @brief Gets the fastest kernel the CPU can run (chosen once)
+		 *
+		 * @return The kernel (const Kernel *)
+		 */
+		inline const Kernel *best_kernel() {
+			static const Kernel *kernel = available_kernels().front();
+			return kernel;
+		}
+
+		/**
+		 * @brief The parameters of a network (pointers into the mapped file)
+		 */
+		struct Parameters {
+			const int16_t *feature_biases = nullptr;
+			/**
+			 * @brief The weights of the features (half_dimensions values per feature)
+			 */
+			const int16_t *feature_weights = nullptr;
+			const int32_t *hidden1_biases = nullptr;
+			const int8_t *hidden1_weights = nullptr;
+			const int32_t *hidden2_biases = nullptr;
+			const int8_t *hidden2_weights = nullptr;
+			const int32_t *output_bias = nullptr;
+			const int8_t *output_weights = nullptr;
+		};
+
+		/**
+		 * @brief A network memory mapped from its file (read only, so it can be shared
+		 * by every search thread and its pages by every process)
+		 */
+		class Network {
+			private:
+				void *mapping = nullptr;
+				size_t mapped_size = 0;
+				Parameters parameters;
+
+				/**
+				 * @brief Unmaps the file
+				 */
+				void release() {
+					if (this->mapping)
+						munmap(this->mapping, this->mapped_size);
+					this->mapping = nullptr;
+					this->mapped_size = 0;
+					this->parameters = Parameters();
+				}
+
+			public:
+				/**
+				 * @brief Construct a new Network object from a file
+				 *
+				 * @param path The path of the network file
+				 */
+				explicit Network(const std::string &path) {
+					this->load(path);
+				}
+
+				Network(const Network &) = delete;
+				Network &operator=(const Network &) = delete;
+
+				/**
+				 * @brief Destroy the Network object
+				 *
+				 */
+				~Network() {
+					this->release();
+				}
+
+				/**
+				 * @brief Maps a network file (throws std::invalid_argument if the file can
+				 * not be read or is not a network of this architecture)
+				 *
+				 * @param path The path of the network file
+				 */
+				void load(const std::string &path) {
+					this->release();
+					int fd = open(path.c_str(), O_RDONLY);
+					if (fd < 0)
+						throw std::invalid_argument("Cannot open the network file " + path);
+					struct stat status;
+					if (fstat(fd, &status) != 0 || size_t(status.st_size) != layout.size) {
+						close(fd);
+						throw std::invalid_argument("Wrong size for the network file " + path);
+					}
+					void *mapping = mmap(nullptr, layout.size, PROT_READ, MAP_PRIVATE, fd, 0);
+					close(fd);
+					if (mapping == MAP_FAILED)
+						throw std::invalid_argument("Cannot map the network file " + path);
+					madvise(mapping, layout.size, MADV_WILLNEED);
+					Header header;
+					std::memcpy(&header, mapping, sizeof(header));
+					if (std::memcmp(header.magic, "PCENNUE", 8) != 0 || header.version != file_version || header.features != uint32_t(features) || header.half_dimensions != uint32_t(half_dimensions) || header.hidden_dimensions != uint32_t(hidden_dimensions)) {
+						munmap(mapping, layout.size);
+						throw std::invalid_argument("Unsupported network file " + path);
+					}
+					this->mapping = mapping;
+					this->mapped_size = layout.size;
+					const char *base = static_cast<const char *>(mapping);
+					this->parameters.feature_biases = reinterpret_cast<const int16_t *>(base + layout.feature_biases);
+					this->parameters.feature_weights = reinterpret_cast<const int16_t *>(base + layout.feature_weights);
+					this->parameters.hidden1_biases = reinterpret_cast<const int32_t *>(base + layout.hidden1_biases);
+					this->parameters.hidden1_weights = reinterpret_cast<const int8_t *>(base + layout.hidden1_weights);
+					this->parameters.hidden2_biases = reinterpret_cast<const int32_t *>(base + layout.hidden2_biases);
+					this->parameters.hidden2_weights = reinterpret_cast<const int8_t *>(base + layout.hidden2_weights);
+					this->parameters.output_bias = reinterpret_cast<const int32_t *>(base + layout.output_bias);
+					this->parameters.output_weights = reinterpret_cast<const int8_t *>(base + layout.output_weights);
+				}
+
+				/**
+				 * @brief Gets the parameters
+				 *
+				 * @return The parameters (const Parameters&)
+				 */
+				const Parameters &get_parameters() const {
+					return this->parameters;
+				}
+
+				/**
+				 * @brief Writes a network file with random parameters (to test the file
+				 * format and measure the speed, it does not play well)
+				 *
+				 * @param path The path of the file
+				 * @param seed The seed of the random parameters
+				 */
+				static void write_random(const std::string &path, uint32_t seed = 1) {
+					std::vector<char> data(layout.size, 0);
+					Header header = {{'P', 'C', 'E', 'N', 'N', 'U', 'E', 0}, file_version, features, half_dimensions, hidden_dimensions};
+					std::memcpy(data.data(), &header, sizeof(header));
+					std::mt19937 random(seed);
+					auto fill = [&](size_t offset, size_t count, auto type, int low, int high) {
+						std::uniform_int_distribution<int> values(low, high);
+						for (size_t i = 0; i < count; i++) {
+							decltype(type) value = decltype(type)(values(random));
+							std::memcpy(data.data() + offset + i * sizeof(value), &value, sizeof(value));
+						}
+					};
+					fill(layout.feature_biases, half_dimensions, int16_t(), 0, 64);
+					fill(layout.feature_weights, size_t(half_dimensions) * features, int16_t(), -8, 8);
+					fill(layout.hidden1_biases, hidden_dimensions, int32_t(), -512, 512);
+					fill(layout.hidden1_weights, 2 * half_dimensions * hidden_dimensions, int8_t(), -8, 8);
+					fill(layout.hidden2_biases, hidden_dimensions, int32_t(), -512, 512);
+					fill(layout.hidden2_weights, hidden_dimensions * hidden_dimensions, int8_t(), -32, 32);
+					fill(layout.output_bias, 1, int32_t(), -64, 64);
+					fill(layout.output_weights, hidden_dimensions, int8_t(), -64, 64);
+					std::ofstream file(path, std::ios::binary | std::ios::trunc);
+					if (!file.write(data.data(), std::streamsize(data.size())))
+						throw std::invalid_argument("Cannot write the network file " + path);
+				}
+		};
+
+		/**
+		 * @brief The accumulators of a position (one per side, indexed by color: 0 =
+		 * white, 1 = black)
+		 */
+		struct alignas(64) Accumulator {
+			std::array<std::array<int16_t, half_dimensions>, 2> values;
+		};
+
+		/**
+		 * @brief Evaluates the positions of a search with a network: the accumulators
+		 * of each ply are computed from the previous ones with the pieces that moved
+		 * (a side is only recomputed from its pieces when its king moves). One
+		 * evaluator per thread.
+		 */
+		class Evaluator {
+			private:
+				const Parameters &parameters;
+				const Kernel *kernel;
+				/**
+				 * @brief The accumulators of each ply (the current one is accumulators[ply])
+				 */
+				std::vector<Accumulator> accumulators;
+				int ply = 0;
+
+				/**
+				 * @brief Computes the accumulator of a side from all its features
+				 *
+				 * @param board The position
+				 * @param accumulator The accumulator
+				 * @param white The side
+				 */
+				void refresh(const board::Board &board, Accumulator &accumulator, bool white) {
+					std::array<const int16_t *, 32> added;
+					int count = 0;
+					int king = board::bitboards::lsb(board.get_pieces(white, board::pieces::piece_type::k));
+					board::bitboards::Bitboard kings = board.get_pieces(true, board::pieces::piece_type::k) | board.get_pieces(false, board::pieces::piece_type::k);
+					for (board::bitboards::Bitboard b = board.get_occupied() & ~kings; b; b &= b - 1) {
+						int sq = board::bitboards::lsb(b);
+						added[count++] = this->parameters.feature_weights + feature_index(white, king, board.get_piece_code(sq), sq) * half_dimensions;
+					}
+					this->kernel->update(accumulator.values[white ? 0 : 1].data(), this->parameters.feature_biases, added.data(), count, nullptr, 0);
+				}
+
+			public:
+				/**
+				 * @brief Construct a new Evaluator object
+				 *
+				 * @param network The network (must outlive the evaluator)
+				 * @param kernel The kernel (the fastest the CPU can run by default)
+				 */
+				Evaluator(const Network &network, const Kernel *kernel = best_kernel()) : parameters(network.get_parameters()), kernel(kernel), accumulators(1) {}
+
+				/**
+				 * @brief Computes the accumulators of a position from scratch (the root of a
+				 * search)
+				 *
+				 * @param board The position
+				 */
+				void reset(const board::Board &board) {
+					this->ply = 0;
+					this->refresh(board, this->accumulators[0], true);
+					this->refresh(board, this->accumulators[0], false);
+				}
+
+				/**
+				 * @brief Computes the accumulators after a move from the ones before it
+				 *
+				 * @param board The position after the move
+				 * @param undo The information returned by Board::make_move
+				 */
+				void push(const board::Board &board, const board::UndoInfo &undo) {
+					if (++this->ply == int(this->accumulators.size()))
+						this->accumulators.emplace_back();
+					const Accumulator &previous = this->accumulators[this->ply - 1];
+					Accumulator &current = this->accumulators[this->ply];
+					// The pieces removed and added (code, square), kings included
+					std::array<std::array<int, 2>, 2> removed, added;
+					int removed_count = 0, added_count = 0;
+					removed[removed_count++] = {undo.moved, undo.from};
+					added[added_count++] = {board.get_piece_code(undo.to), undo.to};
+					if (undo.captured >= 0)
+						removed[removed_count++] = {undo.captured, undo.captured_square};
+					bool king_moved = undo.moved % 6 == board::pieces::piece_type::k;
+					if (king_moved && std::abs(undo.to - undo.from) == 2) {
+						int rook = board::pieces::piece_type::r + (undo.moved < 6 ? 0 : 6);
+						removed[removed_count++] = {rook, undo.to > undo.from ? undo.from + 3 : undo.from - 4};
+						added[added_count++] = {rook, (undo.from + undo.to) / 2};
+					}
+					for (int side = 0; side < 2; side++) {
+						bool white = side == 0;
+						if (king_moved && white == (undo.moved < 6)) {
+							this->refresh(board, current, white);
+							continue;
+						}
+						int king = board::bitboards::lsb(board.get_pieces(white, board::pieces::piece_type::k));
+						std::array<const int16_t *, 2> added_rows, removed_rows;
+						int added_rows_count = 0, removed_rows_count = 0;
+						for (int i = 0; i < added_count; i++)
+							if (added[i][0] % 6 != board::pieces::piece_type::k)
+								added_rows[added_rows_count++] = this->parameters.feature_weights + feature_index(white, king, added[i][0], added[i][1]) * half_dimensions;
+						for (int i = 0; i < removed_count; i++)
+							if (removed[i][0] % 6 != board::pieces::piece_type::k)
+								removed_rows[removed_rows_count++] = this->parameters.feature_weights + feature_index(white, king, removed[i][0], removed[i][1]) * half_dimensions;
+						this->kernel->update(current.values[side].data(), previous.values[side].data(), added_rows.data(), added_rows_count, removed_rows.data(), removed_rows_count);
+					}
+				}
+
+				/**
+				 * @brief Goes back to the accumulators before the last move pushed
+				 */
+				void pop() {
+					this->ply--;
+				}
+
+				/**
+				 * @brief Evaluates the current position with the network
+				 *
+				 * @param board The current position
+				 * @return The score for the side to move (in centipawns) (int)
+				 */
+				int evaluate(const board::Board &board) const {
+					const Accumulator &accumulator = this->accumulators[this->ply];
+					int us = board.is_white_turn() ? 0 : 1;
+					alignas(64) std::array<uint8_t, 2 * half_dimensions> transformed;
+					this->kernel->activate(accumulator.values[us].data(), transformed.data());
+					this->kernel->activate(accumulator.values[us ^ 1].data(), transformed.data() + half_dimensions);
+					alignas(64) std::array<int32_t, hidden_dimensions> sums;
+					alignas(64) std::array<uint8_t, hidden_dimensions> hidden;
+					this->kernel->affine(transformed.data(), 2 * half_dimensions, this->parameters.hidden1_weights, this->parameters.hidden1_biases, sums.data(), hidden_dimensions);
+					for (int i = 0; i < hidden_dimensions; i++)
+						hidden[i] = uint8_t(std::clamp(sums[i] >> weight_shift, 0, 127));
+					this->kernel->affine(hidden.data(), hidden_dimensions, this->parameters.hidden2_weights, this->parameters.hidden2_biases, sums.data(), hidden_dimensions);
+					for (int i = 0; i < hidden_dimensions; i++)
+						hidden[i] = uint8_t(std::clamp(sums[i] >> weight_shift, 0, 127));
+					int32_t output;
+					this->kernel->affine(hidden.data(), hidden_dimensions, this->parameters.output_weights, this->parameters.output_bias, &output, 1);
+					return output / output_scale;
+				}
+		};
+	} // namespace nnue
+} // namespace PlayeChessEngine
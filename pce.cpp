@@ -8,9 +8,17 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <stdexcept>
 #include <array>
 #include <vector>
 #include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 /**
  * @brief PlayeChessEngine is the namespace for the PCE engine who is made for
@@ -50,6 +58,12 @@ namespace PlayeChessEngine {
 			 */
 			bool is_valid = false;
 
+			/**
+			 * @brief The type of the piece to promote to (refer to the
+			 * board::pieces::piece_type enum, -1 if the move is not a promotion)
+			 */
+			int promotion = -1;
+
 		public:
 			/**
 			 * @brief Construct a new Move object
@@ -74,26 +88,62 @@ namespace PlayeChessEngine {
 			 */
 			std::string show() {
 				std::string files = "abcdefgh";
-				return std::string(1, files[start_square_y]) + std::to_string(start_square_x + 1) + " -> " + std::string(1, files[end_square_y]) + std::to_string(end_square_x + 1);
+				std::string promotions = "PRNBQK";
+				std::string shown = std::string(1, files[start_square_y]) + std::to_string(start_square_x + 1) + " -> " + std::string(1, files[end_square_y]) + std::to_string(end_square_x + 1);
+				if (this->promotion >= 0)
+					shown += "=" + std::string(1, promotions[this->promotion]);
+				return shown;
+			}
+
+			/**
+			 * @brief Shows the move in long algebraic notation (e.g. e2e4, e7e8q)
+			 *
+			 * @return Formatted move (std::string)
+			 */
+			std::string notation() {
+				std::string files = "abcdefgh";
+				std::string promotions = "prnbqk";
+				std::string shown = std::string(1, files[start_square_y]) + std::to_string(start_square_x + 1) + std::string(1, files[end_square_y]) + std::to_string(end_square_x + 1);
+				if (this->promotion >= 0)
+					shown += promotions[this->promotion];
+				return shown;
 			}
 
 			/**
 			 * @brief Get the start coords
 			 *
-			 * @return The start coords (std::vector<int>)
+			 * @return The start coords (std::array<int, 2>)
 			 */
-			std::vector<int> get_start_coords() {
+			std::array<int, 2> get_start_coords() const {
 				return {this->start_square_x, this->start_square_y};
 			}
 			/**
 			 * @brief Get the end coords
 			 *
-			 * @return The end coords (std::vector<int>)
+			 * @return The end coords (std::array<int, 2>)
 			 */
-			std::vector<int> get_end_coords() {
+			std::array<int, 2> get_end_coords() const {
 				return {this->end_square_x, this->end_square_y};
 			}
 
+			/**
+			 * @brief Get the start square (x * 8 + y)
+			 *
+			 * @return The start square (int)
+			 */
+			int get_start_square() const {
+				return this->start_square_x * 8 + this->start_square_y;
+			}
+
+			/**
+			 * @brief Get the end square (x * 8 + y)
+			 *
+			 * @return The end square (int)
+			 */
+			int get_end_square() const {
+				return this->end_square_x * 8 + this->end_square_y;
+			}
+
 			/**
 			 * @brief Set if the move is a capture
 			 *
@@ -130,15 +180,34 @@ namespace PlayeChessEngine {
 				return this->is_valid;
 			}
 
+			/**
+			 * @brief Set the type of the piece to promote to
+			 *
+			 * @param promotion The piece type (refer to the board::pieces::piece_type
+			 * enum, -1 if the move is not a promotion)
+			 */
+			void set_promotion(int promotion) {
+				this->promotion = promotion;
+			}
+
+			/**
+			 * @brief Get the type of the piece to promote to
+			 *
+			 * @return The piece type (-1 if the move is not a promotion)
+			 */
+			int get_promotion() {
+				return this->promotion;
+			}
+
 			/**
 			 * @brief Checks if the move is in a vector of moves
 			 *
 			 * @param moves The vector of moves
 			 * @return True if the move is in the vector, false if not (bool)
 			 */
-			bool am_in(std::vector<Move> moves) {
-				for (int i = 0; i < moves.size(); i++) {
-					if (moves[i].get_end_coords()[0] == this->get_end_coords()[0] && moves[i].get_end_coords()[1] == this->get_end_coords()[1])
+			bool am_in(const std::vector<Move> &moves) const {
+				for (const Move &move : moves) {
+					if (move.get_end_square() == this->get_end_square())
 						return true;
 				}
 				return false;
@@ -151,495 +220,2234 @@ namespace PlayeChessEngine {
 	namespace board {
 
 		/**
-		 * @brief Namespace for things related to the pieces
+		 * @brief Namespace for the bitboard primitives (one bit per square, a1 = bit
+		 * 0, h1 = bit 7, h8 = bit 63)
 		 */
-		namespace pieces {
+		namespace bitboards {
 
 			/**
-			 * @brief The piece type enum (p = pawn, r = rook, n = knight, b = bishop, q =
-			 * queen, k = king)
+			 * @brief A set of squares (bit n is set if square n is in the set)
 			 */
-			enum piece_type { p, r, n, b, q, k };
+			typedef uint64_t Bitboard;
 
 			/**
-			 * @brief The piece class (abstract)
+			 * @brief Gets the square index of coordinates
+			 *
+			 * @param x The x coordinate (0-7, the rank)
+			 * @param y The y coordinate (0-7, the file)
+			 * @return The square index (0-63)
 			 */
-			class Piece {
-				protected:
-					/**
-					 * @brief The type of the piece
-					 */
-					piece_type type;
-					/**
-					 * @brief The coordinates of the piece
-					 */
-					int coords[2] = {0, 0};
+			constexpr int square(int x, int y) { return x * 8 + y; }
 
-				public:
-					/**
-					 * @brief The color of the piece (true = white, false = black)
-					 */
-					bool is_white;
-					/**
-					 * @brief If the piece has moved (used for castling)
-					 */
-					bool has_moved = false;
+			/**
+			 * @brief Gets the x coordinate (rank) of a square
+			 *
+			 * @param sq The square index
+			 * @return The x coordinate (int)
+			 */
+			constexpr int square_x(int sq) { return sq >> 3; }
 
-					/**
-					 * @brief Construct a new Piece object
-					 *
-					 * @param type The type of the piece (refer to the piece_type enum)
-					 * @param is_white The color of the piece (true = white, false = black)
-					 * @param x The x coordinate of the piece (0-7)
-					 * @param y The y coordinate of the piece (0-7)
-					 */
-					Piece(piece_type type, bool is_white, int x, int y) {
-						this->type = type;
-						this->is_white = is_white;
-						this->coords[0] = x;
-						this->coords[1] = y;
-					}
+			/**
+			 * @brief Gets the y coordinate (file) of a square
+			 *
+			 * @param sq The square index
+			 * @return The y coordinate (int)
+			 */
+			constexpr int square_y(int sq) { return sq & 7; }
 
-					/**
-					 * @brief Destroy the Piece object
-					 */
-					virtual ~Piece() {}
+			/**
+			 * @brief Gets the bitboard of a single square
+			 *
+			 * @param sq The square index
+			 * @return The bitboard with only this square set (Bitboard)
+			 */
+			constexpr Bitboard bit(int sq) { return Bitboard(1) << sq; }
 
-					/**
-					 * @brief Validates the move of the piece (abstract)
-					 *
-					 * @return If the move is valid (bool)
-					 */
-					virtual bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						return false;
-					}
+			/**
+			 * @brief Counts the squares of a bitboard
+			 *
+			 * @param bb The bitboard
+			 * @return The number of squares set (int)
+			 */
+			inline int popcount(Bitboard bb) { return __builtin_popcountll(bb); }
 
-					/**
-					 * @brief Updates the coordinates of the piece
-					 *
-					 * @param x The new x coordinate of the piece (0-7)
-					 * @param y The new y coordinate of the piece (0-7)
-					 */
-					void update_coords(int x, int y) {
-						this->coords[0] = x;
-						this->coords[1] = y;
-					}
+			/**
+			 * @brief Gets the lowest square of a (non empty) bitboard
+			 *
+			 * @param bb The bitboard
+			 * @return The square index (int)
+			 */
+			inline int lsb(Bitboard bb) { return __builtin_ctzll(bb); }
 
-					/**
-					 * @brief Get the type object
-					 * 
-					 * @return piece_type 
-					 */
-					piece_type get_type() { return this->type; }
+			/**
+			 * @brief Gets the highest square of a (non empty) bitboard
+			 *
+			 * @param bb The bitboard
+			 * @return The square index (int)
+			 */
+			inline int msb(Bitboard bb) { return 63 - __builtin_clzll(bb); }
 
-					/**
-					 * @brief Validates the move of the piece (checks if the landing square is
-					 * valid)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the landing square is valid (bool)
-					 */
-					bool validate_validation(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						if (board[x_final][y_final] == nullptr)
-							return true;
-						if (board[x_final][y_final]->is_white == this->is_white)
-							return false;
-						return true;
-					}
+			/**
+			 * @brief Removes the lowest square of a (non empty) bitboard and returns it
+			 *
+			 * @param bb The bitboard
+			 * @return The square index (int)
+			 */
+			inline int pop_lsb(Bitboard &bb) {
+				int sq = lsb(bb);
+				bb &= bb - 1;
+				return sq;
+			}
 
-					/**
-					 * @brief Checks the path from the piece to the landing square
-					 *
-					 * @param x_final The final x coordinate
-					 * @param y_final The final y coordinate
-					 * @param board The board
-					 * @return Whether the path is clear (bool)
-					 */
-					bool check_path(int x_final, int y_final, std::array<std::array<Piece *, 8>, 8> board) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if (x_diff == 0) {
-							if (y_diff > 0) {
-								for (int i = 1; i < y_diff; i++) {
-									if (board[this->coords[0]][this->coords[1] + i] != nullptr)
-										return false;
-								}
-							} else {
-								for (int i = 1; i < abs(y_diff); i++) {
-									if (board[this->coords[0]][this->coords[1] - i] != nullptr)
-										return false;
-								}
-							}
-						} else if (y_diff == 0) {
-							if (x_diff > 0) {
-								for (int i = 1; i < x_diff; i++) {
-									if (board[this->coords[0] + i][this->coords[1]] != nullptr)
-										return false;
-								}
-							} else {
-								for (int i = 1; i < abs(x_diff); i++) {
-									if (board[this->coords[0] - i][this->coords[1]] != nullptr)
-										return false;
-								}
-							}
-						} else if (abs(x_diff) == abs(y_diff)) {
-							if (x_diff > 0 && y_diff > 0) {
-								for (int i = 1; i < x_diff; i++) {
-									if (board[this->coords[0] + i][this->coords[1] + i] != nullptr)
-										return false;
-								}
-							} else if (x_diff < 0 && y_diff < 0) {
-								for (int i = 1; i < abs(x_diff); i++) {
-									if (board[this->coords[0] - i][this->coords[1] - i] != nullptr)
-										return false;
-								}
-							} else if (x_diff > 0 && y_diff < 0) {
-								for (int i = 1; i < x_diff; i++) {
-									if (board[this->coords[0] + i][this->coords[1] - i] != nullptr)
-										return false;
-								}
-							} else if (x_diff < 0 && y_diff > 0) {
-								for (int i = 1; i < abs(x_diff); i++) {
-									if (board[this->coords[0] - i][this->coords[1] + i] != nullptr)
-										return false;
-								}
-							}
-						}
-						return true;
+			/**
+			 * @brief Gets the bitboard of a whole row
+			 *
+			 * @param x The row (0-7)
+			 * @return The bitboard of the row (Bitboard)
+			 */
+			constexpr Bitboard row(int x) { return Bitboard(0xFF) << (8 * x); }
+
+			/**
+			 * @brief Gets the bitboard of a whole column
+			 *
+			 * @param y The column (0-7)
+			 * @return The bitboard of the column (Bitboard)
+			 */
+			constexpr Bitboard column(int y) { return Bitboard(0x0101010101010101ULL) << y; }
+
+			/**
+			 * @brief Shifts every square of a bitboard by a fixed offset (squares
+			 * shifted out of the board are lost)
+			 *
+			 * @tparam Offset The offset (8 = one row up, -8 = one row down)
+			 * @param bb The bitboard
+			 * @return The shifted bitboard (Bitboard)
+			 */
+			template <int Offset>
+			constexpr Bitboard shift(Bitboard bb) { return Offset > 0 ? bb << Offset : bb >> -Offset; }
+
+			/**
+			 * @brief The precomputed moves of the leaping pieces (knights, kings and
+			 * pawns) from every square
+			 */
+			struct LeaperTables {
+				/**
+				 * @brief The squares attacked by a knight
+				 */
+				std::array<Bitboard, 64> knight = {};
+				/**
+				 * @brief The squares attacked by a king
+				 */
+				std::array<Bitboard, 64> king = {};
+				/**
+				 * @brief The squares attacked by a pawn (indexed by color then square, 0 =
+				 * white, 1 = black)
+				 */
+				std::array<std::array<Bitboard, 64>, 2> pawn_attacks = {};
+				/**
+				 * @brief The square a pawn pushes to (indexed by color then square, 0 =
+				 * white, 1 = black)
+				 */
+				std::array<std::array<Bitboard, 64>, 2> pawn_pushes = {};
+
+				/**
+				 * @brief Gets the squares reached from a square by a list of offsets
+				 *
+				 * @param sq The start square
+				 * @param offsets The offsets ({x, y})
+				 * @param count The number of offsets
+				 * @return The squares reached (Bitboard)
+				 */
+				static constexpr Bitboard jumps(int sq, const int (*offsets)[2], int count) {
+					Bitboard bb = 0;
+					for (int i = 0; i < count; i++) {
+						int x = square_x(sq) + offsets[i][0];
+						int y = square_y(sq) + offsets[i][1];
+						if (x >= 0 && x < 8 && y >= 0 && y < 8)
+							bb |= bit(square(x, y));
 					}
+					return bb;
+				}
 
-					/**
-					 * @brief Shows the piece in a readable format
-					 *
-					 * @return The formatted piece (std::string)
-					 */
-					std::string show() {
-						if (this->is_white) {
-							std::string piece_names[6] = {"P", "R", "N", "B", "Q", "K"};
-							return piece_names[this->type];
+				/**
+				 * @brief Construct the tables (at compile time)
+				 */
+				constexpr LeaperTables() {
+					const int knight_offsets[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+					const int king_offsets[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+					const int pawn_offsets[2][3][2] = {{{1, -1}, {1, 1}, {1, 0}}, {{-1, -1}, {-1, 1}, {-1, 0}}};
+					for (int sq = 0; sq < 64; sq++) {
+						this->knight[sq] = jumps(sq, knight_offsets, 8);
+						this->king[sq] = jumps(sq, king_offsets, 8);
+						for (int color = 0; color < 2; color++) {
+							this->pawn_attacks[color][sq] = jumps(sq, pawn_offsets[color], 2);
+							this->pawn_pushes[color][sq] = jumps(sq, pawn_offsets[color] + 2, 1);
 						}
-						std::string piece_names[6] = {"p", "r", "n", "b", "q", "k"};
-						return piece_names[this->type];
 					}
+				}
 			};
 
 			/**
-			 * @brief The pawn piece (inherits from Piece)
-			 *
+			 * @brief The leaper tables (generated at compile time)
 			 */
-			class Pawn : public Piece {
-				private:
-					/**
-					 * @brief If the pawn has moved
-					 *
-					 */
-					bool has_moved = false;
+			inline constexpr LeaperTables leapers;
 
-				public:
-					/**
-					 * @brief Construct a new Pawn object
-					 *
-					 * @param is_white Whether the pawn is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the pawn
-					 * @param y The y coordinate of the pawn
-					 */
-					Pawn(bool is_white, int x, int y) : Piece(p, is_white, x, y){}
+			/**
+			 * @brief The squares between, the lines through and the distance between every
+			 * pair of squares, and the rays of the sliding pieces on an empty board
+			 */
+			struct GeometryTables {
+				/**
+				 * @brief The squares strictly between two aligned squares
+				 */
+				std::array<std::array<Bitboard, 64>, 64> between = {};
+				/**
+				 * @brief The full line through two aligned squares
+				 */
+				std::array<std::array<Bitboard, 64>, 64> line = {};
+				/**
+				 * @brief The number of king steps between two squares
+				 */
+				std::array<std::array<uint8_t, 64>, 64> distance = {};
+				/**
+				 * @brief The squares a rook reaches on an empty board
+				 */
+				std::array<Bitboard, 64> rook_rays = {};
+				/**
+				 * @brief The squares a bishop reaches on an empty board
+				 */
+				std::array<Bitboard, 64> bishop_rays = {};
+				/**
+				 * @brief The squares reached in one direction on an empty board (even
+				 * indexes go up the square indexes, odd indexes go down: 0-1 = columns,
+				 * 2-3 = rows, 4-7 = diagonals)
+				 */
+				std::array<std::array<Bitboard, 64>, 8> rays = {};
 
-					/**
-					 * @brief Validates the move of the pawn (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						// TODO Add pawn takes
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-
-						if (y_diff == 0 && x_diff != 0) {
-							if (this->is_white) {
-								if (x_diff == 1) {
-									if (board[x_final][y_final] == nullptr)
-										return true;
-								} else if (x_diff == 2 && !this->has_moved && this->coords[0] == 1) {
-									if (board[x_final][y_final] == nullptr && board[x_final][y_final - 1] == nullptr)
-										return true;
-								}
-							} else {
-								if (x_diff == -1) {
-									if (board[x_final][y_final] == nullptr)
-										return true;
-								} else if (x_diff == -2 && !has_moved && this->coords[0] == 6) {
-									if (board[x_final][y_final] == nullptr && board[x_final][y_final + 1] == nullptr)
-										return true;
+				/**
+				 * @brief Construct the tables (at compile time)
+				 */
+				constexpr GeometryTables() {
+					const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+					for (int sq = 0; sq < 64; sq++) {
+						for (int to = 0; to < 64; to++) {
+							int dx = square_x(to) - square_x(sq);
+							int dy = square_y(to) - square_y(sq);
+							dx = dx < 0 ? -dx : dx;
+							dy = dy < 0 ? -dy : dy;
+							this->distance[sq][to] = uint8_t(dx > dy ? dx : dy);
+						}
+						for (int d = 0; d < 4; d++) {
+							Bitboard full = bit(sq);
+							for (int sign = -1; sign <= 1; sign += 2) {
+								Bitboard ray = 0;
+								int x = square_x(sq) + sign * directions[d][0];
+								int y = square_y(sq) + sign * directions[d][1];
+								for (; x >= 0 && x < 8 && y >= 0 && y < 8; x += sign * directions[d][0], y += sign * directions[d][1]) {
+									this->between[sq][square(x, y)] = ray;
+									ray |= bit(square(x, y));
 								}
+								this->rays[d * 2 + (sign > 0 ? 0 : 1)][sq] = ray;
+								full |= ray;
 							}
-						} else if (abs(y_diff) == 1 && abs(x_diff) == 1) {
-							if (this->is_white) {
-								if (x_diff == 1) {
-									if (board[x_final][y_final] != nullptr && !board[x_final][y_final]->is_white)
-										return true;
-								}
-							} else {
-								if (x_diff == -1) {
-									if (board[x_final][y_final] != nullptr && board[x_final][y_final]->is_white)
-										return true;
-								}
+							if (d < 2)
+								this->rook_rays[sq] |= full & ~bit(sq);
+							else
+								this->bishop_rays[sq] |= full & ~bit(sq);
+							for (int to = 0; to < 64; to++) {
+								if (to != sq && (full & bit(to)))
+									this->line[sq][to] = full;
 							}
 						}
-						return false;
 					}
+				}
 			};
 
 			/**
-			 * @brief The rook piece (inherits from Piece)
+			 * @brief The geometry tables (generated at compile time)
+			 */
+			inline constexpr GeometryTables geometry;
+
+			/**
+			 * @brief Gets the squares a rook reaches on an empty board
 			 *
+			 * @param sq The square of the rook
+			 * @return The squares (Bitboard)
 			 */
-			class Rook : public Piece {
-				private:
-					/**
-					 * @brief If the rook has moved
-					 *
-					 */
-					bool has_moved = false;
+			constexpr Bitboard rook_rays(int sq) { return geometry.rook_rays[sq]; }
 
-				public:
-					/**
-					 * @brief Construct a new Rook object
-					 *
-					 * @param is_white Whether the rook is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the rook
-					 * @param y The y coordinate of the rook
-					 */
-					Rook(bool is_white, int x, int y) : Piece(r, is_white, x, y) {}
+			/**
+			 * @brief Gets the squares a bishop reaches on an empty board
+			 *
+			 * @param sq The square of the bishop
+			 * @return The squares (Bitboard)
+			 */
+			constexpr Bitboard bishop_rays(int sq) { return geometry.bishop_rays[sq]; }
 
-					/**
-					 * @brief Validates the move of the rook (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if (x_diff * y_diff == 0 && x_diff != y_diff) {
-							if (validate_validation(board, x_final, y_final))
-								return this->check_path(x_final, y_final, board);
-						}
-						return false;
-					}
-			};
+			/**
+			 * @brief Gets the squares strictly between two squares (empty if they are not
+			 * on the same line or diagonal)
+			 *
+			 * @param from The first square
+			 * @param to The second square
+			 * @return The squares between (Bitboard)
+			 */
+			constexpr Bitboard between(int from, int to) { return geometry.between[from][to]; }
 
 			/**
-			 * @brief The knight piece (inherits from Piece)
+			 * @brief Gets the full line (rank, file or diagonal) through two aligned
+			 * squares
 			 *
+			 * @param from The first square
+			 * @param to The second square
+			 * @return The line, including both squares (0 if they are not aligned)
+			 * (Bitboard)
 			 */
-			class Knight : public Piece {
-				public:
-					/**
-					 * @brief Construct a new Knight object
-					 *
-					 * @param is_white Whether the knight is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the knight
-					 * @param y The y coordinate of the knight
-					 */
-					Knight(bool is_white, int x, int y) : Piece(n, is_white, x, y) {}
+			constexpr Bitboard line(int from, int to) { return geometry.line[from][to]; }
 
-					/**
-					 * @brief Validates the move of the knight (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if ((abs(x_diff) == 2 && abs(y_diff) == 1) || (abs(x_diff) == 1 && abs(y_diff) == 2))
-							return validate_validation(board, x_final, y_final);
-						return false;
-					}
-			};
+			/**
+			 * @brief Gets the number of king steps between two squares
+			 *
+			 * @param from The first square
+			 * @param to The second square
+			 * @return The distance (int)
+			 */
+			constexpr int distance(int from, int to) { return geometry.distance[from][to]; }
 
 			/**
-			 * @brief The bishop piece (inherits from Piece)
+			 * @brief Gets the squares attacked by a knight
 			 *
+			 * @param sq The square of the knight
+			 * @return The attacked squares (Bitboard)
 			 */
-			class Bishop : public Piece {
-				public:
-					/**
-					 * @brief Construct a new Bishop object
-					 *
-					 * @param is_white Whether the bishop is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the bishop
-					 * @param y The y coordinate of the bishop
-					 */
-					Bishop(bool is_white, int x, int y) : Piece(b, is_white, x, y) {}
+			constexpr Bitboard knight_attacks(int sq) { return leapers.knight[sq]; }
 
-					/**
-					 * @brief Validates the move of the bishop (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if (abs(x_diff) == abs(y_diff) && x_diff != 0) {
-							if (validate_validation(board, x_final, y_final))
-								return this->check_path(x_final, y_final, board);
-						}
-						return false;
-					}
-			};
+			/**
+			 * @brief Gets the squares attacked by a king
+			 *
+			 * @param sq The square of the king
+			 * @return The attacked squares (Bitboard)
+			 */
+			constexpr Bitboard king_attacks(int sq) { return leapers.king[sq]; }
 
 			/**
-			 * @brief The queen piece (inherits from Piece)
+			 * @brief Gets the squares attacked by a pawn
 			 *
+			 * @param white If the pawn is white
+			 * @param sq The square of the pawn
+			 * @return The attacked squares (Bitboard)
 			 */
-			class Queen : public Piece {
-				public:
-					/**
-					 * @brief Construct a new Queen object
-					 *
-					 * @param is_white Whether the queen is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the queen
-					 * @param y The y coordinate of the queen
-					 */
-					Queen(bool is_white, int x, int y) : Piece(q, is_white, x, y) {}
+			constexpr Bitboard pawn_attacks(bool white, int sq) { return leapers.pawn_attacks[white ? 0 : 1][sq]; }
 
-					/**
-					 * @brief Validates the move of the queen (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if ((abs(x_diff) == abs(y_diff) && x_diff != 0) || ((x_diff == 0 || y_diff == 0) && x_diff != y_diff)) {
-							if (validate_validation(board, x_final, y_final))
-								return this->check_path(x_final, y_final, board);
-						}
-						return false;
-					}
-			};
+			/**
+			 * @brief Gets the square a pawn pushes to (one step forward)
+			 *
+			 * @param white If the pawn is white
+			 * @param sq The square of the pawn
+			 * @return The push square (Bitboard, empty on the last row)
+			 */
+			constexpr Bitboard pawn_pushes(bool white, int sq) { return leapers.pawn_pushes[white ? 0 : 1][sq]; }
 
 			/**
-			 * @brief The king piece (inherits from Piece)
+			 * @brief Gets the squares attacked by a sliding piece by cutting its rays at
+			 * the first blocker (used to fill the lookup tables)
 			 *
+			 * @param sq The square of the piece
+			 * @param occupied The occupied squares
+			 * @param rook If the piece slides like a rook (or like a bishop)
+			 * @return The attacked squares (Bitboard)
 			 */
-			class King : public Piece {
-				private:
-					/**
-					 * @brief Whether the king has moved or not
-					 *
-					 */
-					bool has_moved = false;
+			inline Bitboard sliding_attacks(int sq, Bitboard occupied, bool rook) {
+				Bitboard attacks = 0;
+				for (int direction = rook ? 0 : 4; direction < (rook ? 4 : 8); direction++) {
+					Bitboard ray = geometry.rays[direction][sq];
+					Bitboard blockers = ray & occupied;
+					if (blockers)
+						ray ^= geometry.rays[direction][direction % 2 == 0 ? lsb(blockers) : msb(blockers)];
+					attacks |= ray;
+				}
+				return attacks;
+			}
 
-				public:
-					/**
-					 * @brief Construct a new King object
-					 *
-					 * @param is_white Whether the king is white or black (true = white, false =
-					 * black)
-					 * @param x The x coordinate of the king
-					 * @param y The y coordinate of the king
-					 */
-					King(bool is_white, int x, int y) : Piece(k, is_white, x, y) {}
+			/**
+			 * @brief Checks if the CPU has the BMI2 instructions (for PEXT)
+			 *
+			 * @return If BMI2 is available (bool)
+			 */
+			inline bool cpu_has_bmi2() {
+#if defined(__x86_64__)
+				return __builtin_cpu_supports("bmi2");
+#else
+				return false;
+#endif
+			}
 
-					/**
-					 * @brief Validates the move of the king (combines the other validation
-					 * functions)
-					 *
-					 * @param board The board
-					 * @param x_final The x coordinate of the landing square
-					 * @param y_final The y coordinate of the landing square
-					 * @return If the move is valid (bool)
-					 */
-					bool validation_function(std::array<std::array<Piece *, 8>, 8> board, int x_final, int y_final) {
-						int x_diff = x_final - this->coords[0];
-						int y_diff = y_final - this->coords[1];
-						if (abs(x_diff) <= 1 && abs(y_diff) <= 1 && (x_diff != 0 || y_diff != 0)) {
-                            // std::cout << "King validation " << this->coords[0] << " " << this->coords[1] << " - " << x_final << " " << y_final << std::endl;
-							return validate_validation(board, x_final, y_final);
-                        }
-						return false;
+#if defined(__x86_64__)
+			/**
+			 * @brief Extracts the bits of a bitboard selected by a mask (BMI2 PEXT)
+			 *
+			 * @param bb The bitboard
+			 * @param mask The mask
+			 * @return The extracted bits, packed (Bitboard)
+			 */
+			__attribute__((target("bmi2"))) inline Bitboard pext(Bitboard bb, Bitboard mask) { return _pext_u64(bb, mask); }
+#else
+			/**
+			 * @brief Extracts the bits of a bitboard selected by a mask (portable PEXT,
+			 * never used for lookups)
+			 *
+			 * @param bb The bitboard
+			 * @param mask The mask
+			 * @return The extracted bits, packed (Bitboard)
+			 */
+			inline Bitboard pext(Bitboard bb, Bitboard mask) {
+				Bitboard result = 0;
+				for (Bitboard i = 1; mask; i <<= 1, mask &= mask - 1) {
+					if (bb & mask & -mask)
+						result |= i;
+				}
+				return result;
+			}
+#endif
+
+			/**
+			 * @brief The rook magic multipliers of every square (found once with a
+			 * sparse random search, so that no search is needed at startup)
+			 */
+			constexpr Bitboard rook_magics[64] = {
+				0x0A80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+				0xC200209084020008ULL, 0x2100010004000208ULL, 0x0400081000822421ULL, 0x0200010422048844ULL,
+				0x0800800080400024ULL, 0x0001402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+				0x0904802402480080ULL, 0x4040800400020080ULL, 0x0018808042000100ULL, 0x4040800080004100ULL,
+				0x0040048001458024ULL, 0x00A0004000205000ULL, 0x3100808010002000ULL, 0x4825010010000820ULL,
+				0x5004808008000401ULL, 0x2024818004000A00ULL, 0x0005808002000100ULL, 0x2100060004806104ULL,
+				0x0080400880008421ULL, 0x4062220600410280ULL, 0x010A004A00108022ULL, 0x0000100080080080ULL,
+				0x0021000500080010ULL, 0x0044000202001008ULL, 0x0000100400080102ULL, 0xC020128200040545ULL,
+				0x0080002000400040ULL, 0x0000804000802004ULL, 0x0000120022004080ULL, 0x010A386103001001ULL,
+				0x9010080080800400ULL, 0x8440020080800400ULL, 0x0004228824001001ULL, 0x000000490A000084ULL,
+				0x0080002000504000ULL, 0x200020005000C000ULL, 0x0012088020420010ULL, 0x0010010080080800ULL,
+				0x0085001008010004ULL, 0x0002000204008080ULL, 0x0040413002040008ULL, 0x0000304081020004ULL,
+				0x0080204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+				0x5000850800910100ULL, 0x8402019004680200ULL, 0x0120911028020400ULL, 0x0000008044010200ULL,
+				0x0020850200244012ULL, 0x0020850200244012ULL, 0x0000102001040841ULL, 0x140900040A100021ULL,
+				0x000200282410A102ULL, 0x000200282410A102ULL, 0x000200282410A102ULL, 0x4048240043802106ULL
+			};
+
+			/**
+			 * @brief The bishop magic multipliers of every square
+			 */
+			constexpr Bitboard bishop_magics[64] = {
+				0x40106000A1160020ULL, 0x0020010250810120ULL, 0x2010010220280081ULL, 0x002806004050C040ULL,
+				0x0002021018000000ULL, 0x2001112010000400ULL, 0x0881010120218080ULL, 0x1030820110010500ULL,
+				0x0000120222042400ULL, 0x2000020404040044ULL, 0x8000480094208000ULL, 0x0003422A02000001ULL,
+				0x000A220210100040ULL, 0x8004820202226000ULL, 0x0018234854100800ULL, 0x0100004042101040ULL,
+				0x0004001004082820ULL, 0x0010000810010048ULL, 0x1014004208081300ULL, 0x2080818802044202ULL,
+				0x0040880C00A00100ULL, 0x0080400200522010ULL, 0x0001000188180B04ULL, 0x0080249202020204ULL,
+				0x1004400004100410ULL, 0x00013100A0022206ULL, 0x2148500001040080ULL, 0x4241080011004300ULL,
+				0x4020848004002000ULL, 0x10101380D1004100ULL, 0x0008004422020284ULL, 0x01010A1041008080ULL,
+				0x0808080400082121ULL, 0x0808080400082121ULL, 0x0091128200100C00ULL, 0x0202200802010104ULL,
+				0x8C0A020200440085ULL, 0x01A0008080B10040ULL, 0x0889520080122800ULL, 0x100902022202010AULL,
+				0x04081A0816002000ULL, 0x0000681208005000ULL, 0x8170840041008802ULL, 0x0A00004200810805ULL,
+				0x0830404408210100ULL, 0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+				0x0602010120110040ULL, 0x0941010801043000ULL, 0x000040440A210428ULL, 0x0008240020880021ULL,
+				0x0400002012048200ULL, 0x00AC102001210220ULL, 0x0220021002009900ULL, 0x84440C080A013080ULL,
+				0x0001008044200440ULL, 0x0004C04410841000ULL, 0x2000500104011130ULL, 0x1A0C010011C20229ULL,
+				0x0044800112202200ULL, 0x0434804908100424ULL, 0x0300404822C08200ULL, 0x48081010008A2A80ULL
+			};
+
+			/**
+			 * @brief The lookup entry of a sliding piece on a square
+			 */
+			struct Magic {
+				/**
+				 * @brief The relevant occupancy (the rays without their last square)
+				 */
+				Bitboard mask = 0;
+				/**
+				 * @brief The magic multiplier (unused with PEXT)
+				 */
+				Bitboard magic = 0;
+				/**
+				 * @brief The attacks of this square (indexed by the lookup index)
+				 */
+				Bitboard *attacks = nullptr;
+				/**
+				 * @brief The shift of the magic index (64 - number of relevant squares)
+				 */
+				int shift = 0;
+			};
+
+			/**
+			 * @brief The sliding pieces lookup tables (magic bitboards by default, PEXT on
+			 * CPUs with BMI2)
+			 */
+			struct SliderTables {
+				/**
+				 * @brief The rook entries of every square
+				 */
+				std::array<Magic, 64> rook;
+				/**
+				 * @brief The bishop entries of every square
+				 */
+				std::array<Magic, 64> bishop;
+				/**
+				 * @brief The rook attacks of every square and occupancy
+				 */
+				std::vector<Bitboard> rook_table = std::vector<Bitboard>(0x19000);
+				/**
+				 * @brief The bishop attacks of every square and occupancy
+				 */
+				std::vector<Bitboard> bishop_table = std::vector<Bitboard>(0x1480);
+				/**
+				 * @brief If the tables are indexed with PEXT
+				 */
+				bool use_pext = false;
+
+				/**
+				 * @brief Construct the tables (with PEXT if the CPU supports it)
+				 */
+				SliderTables() { this->build(cpu_has_bmi2()); }
+
+				/**
+				 * @brief Gets the lookup index of an occupancy
+				 *
+				 * @param entry The entry of the square
+				 * @param occupied The occupied squares
+				 * @return The index (unsigned)
+				 */
+				unsigned index(const Magic &entry, Bitboard occupied) const {
+					if (this->use_pext)
+						return unsigned(pext(occupied, entry.mask));
+					return unsigned(((occupied & entry.mask) * entry.magic) >> entry.shift);
+				}
+
+				/**
+				 * @brief (Re)builds the tables
+				 *
+				 * @param pext If the tables should be indexed with PEXT (ignored if the CPU
+				 * does not support it)
+				 */
+				void build(bool pext) {
+					this->use_pext = pext && cpu_has_bmi2();
+					this->build_piece(this->rook, this->rook_table.data(), true);
+					this->build_piece(this->bishop, this->bishop_table.data(), false);
+				}
+
+				/**
+				 * @brief Builds the entries of a sliding piece
+				 *
+				 * @param entries The entries to fill
+				 * @param table The attacks table to fill
+				 * @param rook If the piece slides like a rook (or like a bishop)
+				 */
+				void build_piece(std::array<Magic, 64> &entries, Bitboard *table, bool rook) {
+					for (int sq = 0; sq < 64; sq++) {
+						Bitboard edges = ((row(0) | row(7)) & ~row(square_x(sq))) | ((column(0) | column(7)) & ~column(square_y(sq)));
+						Magic &entry = entries[sq];
+						entry.mask = (rook ? rook_rays(sq) : bishop_rays(sq)) & ~edges;
+						entry.magic = rook ? rook_magics[sq] : bishop_magics[sq];
+						entry.shift = 64 - popcount(entry.mask);
+						entry.attacks = sq == 0 ? table : entries[sq - 1].attacks + (size_t(1) << (64 - entries[sq - 1].shift));
+						Bitboard subset = 0;
+						do {
+							entry.attacks[this->index(entry, subset)] = sliding_attacks(sq, subset, rook);
+							subset = (subset - entry.mask) & entry.mask;
+						} while (subset);
 					}
+				}
 			};
-		} // namespace pieces
+
+			/**
+			 * @brief The sliding pieces lookup tables (filled once at startup, the only
+			 * tables not generated at compile time)
+			 */
+			inline SliderTables sliders;
+
+			/**
+			 * @brief Gets the squares attacked by a rook
+			 *
+			 * @param sq The square of the rook
+			 * @param occupied The occupied squares
+			 * @return The attacked squares (Bitboard)
+			 */
+			inline Bitboard rook_attacks(int sq, Bitboard occupied) {
+				return sliders.rook[sq].attacks[sliders.index(sliders.rook[sq], occupied)];
+			}
+
+			/**
+			 * @brief Gets the squares attacked by a bishop
+			 *
+			 * @param sq The square of the bishop
+			 * @param occupied The occupied squares
+			 * @return The attacked squares (Bitboard)
+			 */
+			inline Bitboard bishop_attacks(int sq, Bitboard occupied) {
+				return sliders.bishop[sq].attacks[sliders.index(sliders.bishop[sq], occupied)];
+			}
+
+			/**
+			 * @brief Gets the squares attacked by a queen
+			 *
+			 * @param sq The square of the queen
+			 * @param occupied The occupied squares
+			 * @return The attacked squares (Bitboard)
+			 */
+			inline Bitboard queen_attacks(int sq, Bitboard occupied) {
+				return rook_attacks(sq, occupied) | bishop_attacks(sq, occupied);
+			}
+		} // namespace bitboards
 
 		/**
-		 * @brief The board class
-		 *
+		 * @brief Namespace for the zobrist hashing of positions
 		 */
-		class Board {
-			private:
+		namespace zobrist {
+
+			/**
+			 * @brief The random keys xored together to hash a position
+			 */
+			struct Keys {
 				/**
-				 * @brief The board
-				 *
+				 * @brief The key of each piece (mailbox code) on each square
 				 */
-				std::array<std::array<pieces::Piece *, 8>, 8> board = {{
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}
-				}};
+				std::array<std::array<uint64_t, 64>, 12> pieces = {};
+				/**
+				 * @brief The key xored when it is black's turn
+				 */
+				uint64_t side = 0;
+				/**
+				 * @brief The key of each set of castling rights
+				 */
+				std::array<uint64_t, 16> castling = {};
+				/**
+				 * @brief The key of each en passant file
+				 */
+				std::array<uint64_t, 8> en_passant = {};
+
+				/**
+				 * @brief Construct the keys (always the same, from a fixed seed, at compile
+				 * time)
+				 */
+				constexpr Keys() {
+					uint64_t seed = 1070372;
+					for (auto &piece : this->pieces) {
+						for (auto &key : piece)
+							key = next(seed);
+					}
+					this->side = next(seed);
+					for (auto &key : this->castling)
+						key = next(seed);
+					for (auto &key : this->en_passant)
+						key = next(seed);
+				}
+
+				/**
+				 * @brief Gets the next number of a xorshift generator
+				 *
+				 * @param seed The state of the generator
+				 * @return The random number (uint64_t)
+				 */
+				static constexpr uint64_t next(uint64_t &seed) {
+					seed ^= seed >> 12;
+					seed ^= seed << 25;
+					seed ^= seed >> 27;
+					return seed * 2685821657736338717ULL;
+				}
+			};
+
+			/**
+			 * @brief The zobrist keys (generated at compile time)
+			 */
+			inline constexpr Keys keys;
+		} // namespace zobrist
+
+		/**
+		 * @brief Namespace for the static evaluation of positions (material and piece
+		 * square tables, tapered between the middlegame and the endgame)
+		 */
+		namespace evaluation {
+
+			/**
+			 * @brief The value of each piece type (p, r, n, b, q, k) in the middlegame and
+			 * in the endgame (in centipawns)
+			 */
+			constexpr std::array<int, 6> middlegame_values = {82, 477, 337, 365, 1025, 0};
+			constexpr std::array<int, 6> endgame_values = {94, 512, 281, 297, 936, 0};
+
+			/**
+			 * @brief The weight of each piece type (p, r, n, b, q, k) in the game phase
+			 * (the phase is max_phase with every piece on the board and 0 with only pawns
+			 * and kings)
+			 */
+			constexpr std::array<int, 6> phase_weights = {0, 2, 1, 1, 4, 0};
+			constexpr int max_phase = 24;
+
+			/**
+			 * @brief The bonus of each piece type (p, r, n, b, q, k) on each square for
+			 * white, from a8 to h1 (as the board is printed), in the middlegame and in the
+			 * endgame
+			 */
+			constexpr std::array<std::array<int, 64>, 6> middlegame_tables = {{
+				{
+					0, 0, 0, 0, 0, 0, 0, 0,
+					98, 134, 61, 95, 68, 126, 34, -11,
+					-6, 7, 26, 31, 65, 56, 25, -20,
+					-14, 13, 6, 21, 23, 12, 17, -23,
+					-27, -2, -5, 12, 17, 6, 10, -25,
+					-26, -4, -4, -10, 3, 3, 33, -12,
+					-35, -1, -20, -23, -15, 24, 38, -22,
+					0, 0, 0, 0, 0, 0, 0, 0,
+				},
+				{
+					32, 42, 32, 51, 63, 9, 31, 43,
+					27, 32, 58, 62, 80, 67, 26, 44,
+					-5, 19, 26, 36, 17, 45, 61, 16,
+					-24, -11, 7, 26, 24, 35, -8, -20,
+					-36, -26, -12, -1, 9, -7, 6, -23,
+					-45, -25, -16, -17, 3, 0, -5, -33,
+					-44, -16, -20, -9, -1, 11, -6, -71,
+					-19, -13, 1, 17, 16, 7, -37, -26,
+				},
+				{
+					-167, -89, -34, -49, 61, -97, -15, -107,
+					-73, -41, 72, 36, 23, 62, 7, -17,
+					-47, 60, 37, 65, 84, 129, 73, 44,
+					-9, 17, 19, 53, 37, 69, 18, 22,
+					-13, 4, 16, 13, 28, 19, 21, -8,
+					-23, -9, 12, 10, 19, 17, 25, -16,
+					-29, -53, -12, -3, -1, 18, -14, -19,
+					-105, -21, -58, -33, -17, -28, -19, -23,
+				},
+				{
+					-29, 4, -82, -37, -25, -42, 7, -8,
+					-26, 16, -18, -13, 30, 59, 18, -47,
+					-16, 37, 43, 40, 35, 50, 37, -2,
+					-4, 5, 19, 50, 37, 37, 7, -2,
+					-6, 13, 13, 26, 34, 12, 10, 4,
+					0, 15, 15, 15, 14, 27, 18, 10,
+					4, 15, 16, 0, 7, 21, 33, 1,
+					-33, -3, -14, -21, -13, -12, -39, -21,
+				},
+				{
+					-28, 0, 29, 12, 59, 44, 43, 45,
+					-24, -39, -5, 1, -16, 57, 28, 54,
+					-13, -17, 7, 8, 29, 56, 47, 57,
+					-27, -27, -16, -16, -1, 17, -2, 1,
+					-9, -26, -9, -10, -2, -4, 3, -3,
+					-14, 2, -11, -2, -5, 2, 14, 5,
+					-35, -8, 11, 2, 8, 15, -3, 1,
+					-1, -18, -9, 10, -15, -25, -31, -50,
+				},
+				{
+					-65, 23, 16, -15, -56, -34, 2, 13,
+					29, -1, -20, -7, -8, -4, -38, -29,
+					-9, 24, 2, -16, -20, 6, 22, -22,
+					-17, -20, -12, -27, -30, -25, -14, -36,
+					-49, -1, -27, -39, -46, -44, -33, -51,
+					-14, -14, -22, -46, -44, -30, -15, -27,
+					1, 7, -8, -64, -43, -16, 9, 8,
+					-15, 36, 12, -54, 8, -28, 24, 14,
+				},
+			}};
+			constexpr std::array<std::array<int, 64>, 6> endgame_tables = {{
+				{
+					0, 0, 0, 0, 0, 0, 0, 0,
+					178, 173, 158, 134, 147, 132, 165, 187,
+					94, 100, 85, 67, 56, 53, 82, 84,
+					32, 24, 13, 5, -2, 4, 17, 17,
+					13, 9, -3, -7, -7, -8, 3, -1,
+					4, 7, -6, 1, 0, -5, -1, -8,
+					13, 8, 8, 10, 13, 0, 2, -7,
+					0, 0, 0, 0, 0, 0, 0, 0,
+				},
+				{
+					13, 10, 18, 15, 12, 12, 8, 5,
+					11, 13, 13, 11, -3, 3, 8, 3,
+					7, 7, 7, 5, 4, -3, -5, -3,
+					4, 3, 13, 1, 2, 1, -1, 2,
+					3, 5, 8, 4, -5, -6, -8, -11,
+					-4, 0, -5, -1, -7, -12, -8, -16,
+					-6, -6, 0, 2, -9, -9, -11, -3,
+					-9, 2, 3, -1, -5, -13, 4, -20,
+				},
+				{
+					-58, -38, -13, -28, -31, -27, -63, -99,
+					-25, -8, -25, -2, -9, -25, -24, -52,
+					-24, -20, 10, 9, -1, -9, -19, -41,
+					-17, 3, 22, 22, 22, 11, 8, -18,
+					-18, -6, 16, 25, 16, 17, 4, -18,
+					-23, -3, -1, 15, 10, -3, -20, -22,
+					-42, -20, -10, -5, -2, -20, -23, -44,
+					-29, -51, -23, -15, -22, -18, -50, -64,
+				},
+				{
+					-14, -21, -11, -8, -7, -9, -17, -24,
+					-8, -4, 7, -12, -3, -13, -4, -14,
+					2, -8, 0, -1, -2, 6, 0, 4,
+					-3, 9, 12, 9, 14, 10, 3, 2,
+					-6, 3, 13, 19, 7, 10, -3, -9,
+					-12, -3, 8, 10, 13, 3, -7, -15,
+					-14, -18, -7, -1, 4, -9, -15, -27,
+					-23, -9, -23, -5, -9, -16, -5, -17,
+				},
+				{
+					-9, 22, 22, 27, 27, 19, 10, 20,
+					-17, 20, 32, 41, 58, 25, 30, 0,
+					-20, 6, 9, 49, 47, 35, 19, 9,
+					3, 22, 24, 45, 57, 40, 57, 36,
+					-18, 28, 19, 47, 31, 34, 39, 23,
+					-16, -27, 15, 6, 9, 17, 10, 5,
+					-22, -23, -30, -16, -16, -23, -36, -32,
+					-33, -28, -22, -43, -5, -32, -20, -41,
+				},
+				{
+					-74, -35, -18, -18, -11, 15, 4, -17,
+					-12, 17, 14, 17, 17, 38, 23, 11,
+					10, 17, 23, 15, 20, 45, 44, 13,
+					-8, 22, 24, 27, 26, 33, 26, 3,
+					-18, -4, 21, 24, 27, 23, 9, -11,
+					-19, -3, 11, 21, 23, 16, 7, -9,
+					-27, -11, 4, 13, 14, 4, -5, -17,
+					-53, -34, -21, -11, -28, -14, -24, -43,
+				},
+			}};
+
+			/**
+			 * @brief The score of each piece (mailbox code) on each square, material
+			 * included, from white's point of view (so black pieces score negatively)
+			 */
+			struct SquareScores {
+				std::array<std::array<int, 64>, 12> middlegame = {};
+				std::array<std::array<int, 64>, 12> endgame = {};
+
+				/**
+				 * @brief Construct the scores from the tables (at compile time)
+				 */
+				constexpr SquareScores() {
+					for (int type = 0; type < 6; type++) {
+						for (int sq = 0; sq < 64; sq++) {
+							// The tables start on the eighth rank, so white reads them flipped
+							int x = sq / 8, y = sq % 8;
+							int white = (7 - x) * 8 + y, black = x * 8 + y;
+							this->middlegame[type][sq] = middlegame_values[type] + middlegame_tables[type][white];
+							this->endgame[type][sq] = endgame_values[type] + endgame_tables[type][white];
+							this->middlegame[type + 6][sq] = -middlegame_values[type] - middlegame_tables[type][black];
+							this->endgame[type + 6][sq] = -endgame_values[type] - endgame_tables[type][black];
+						}
+					}
+				}
+			};
+
+			/**
+			 * @brief The square scores (generated at compile time)
+			 */
+			inline constexpr SquareScores square_scores;
+		} // namespace evaluation
+
+		/**
+		 * @brief The colors (used as a template parameter so that the move generation
+		 * of each color is compiled separately)
+		 */
+		enum class Color { white, black };
+
+		/**
+		 * @brief The constants of a color, known at compile time
+		 *
+		 * @tparam Us The color
+		 */
+		template <Color Us>
+		struct ColorTraits {
+			/**
+			 * @brief If the color is white
+			 */
+			static constexpr bool white = Us == Color::white;
+			/**
+			 * @brief The other color
+			 */
+			static constexpr Color them = white ? Color::black : Color::white;
+			/**
+			 * @brief The index of the color in the bitboard arrays
+			 */
+			static constexpr int index = white ? 0 : 1;
+			/**
+			 * @brief The square offset of a pawn push
+			 */
+			static constexpr int forward = white ? 8 : -8;
+			/**
+			 * @brief The row of the king and rooks at the start (castling row)
+			 */
+			static constexpr int back_rank = white ? 0 : 7;
+			/**
+			 * @brief The row of the pawns at the start
+			 */
+			static constexpr int pawn_rank = white ? 1 : 6;
+			/**
+			 * @brief The row reached by a single push from the start, which can be
+			 * pushed again
+			 */
+			static constexpr int double_push_rank = white ? 2 : 5;
+			/**
+			 * @brief The row of the en passant squares this color can capture on
+			 */
+			static constexpr int en_passant_rank = white ? 5 : 2;
+			/**
+			 * @brief The row where the pawns promote
+			 */
+			static constexpr int promotion_rank = white ? 7 : 0;
+		};
+
+		/**
+		 * @brief Namespace for things related to the pieces
+		 */
+		namespace pieces {
+
+			/**
+			 * @brief The piece type enum (p = pawn, r = rook, n = knight, b = bishop, q =
+			 * queen, k = king)
+			 */
+			enum piece_type { p, r, n, b, q, k };
+
+			/**
+			 * @brief The piece class (abstract)
+			 */
+			class Piece {
+				protected:
+					/**
+					 * @brief The type of the piece
+					 */
+					piece_type type;
+					/**
+					 * @brief The coordinates of the piece
+					 */
+					int coords[2] = {0, 0};
+
+				public:
+					/**
+					 * @brief The color of the piece (true = white, false = black)
+					 */
+					bool is_white;
+					/**
+					 * @brief If the piece has moved (used for castling)
+					 */
+					bool has_moved = false;
+
+					/**
+					 * @brief Construct a new Piece object
+					 *
+					 * @param type The type of the piece (refer to the piece_type enum)
+					 * @param is_white The color of the piece (true = white, false = black)
+					 * @param x The x coordinate of the piece (0-7)
+					 * @param y The y coordinate of the piece (0-7)
+					 */
+					Piece(piece_type type, bool is_white, int x, int y) {
+						this->type = type;
+						this->is_white = is_white;
+						this->coords[0] = x;
+						this->coords[1] = y;
+					}
+
+					/**
+					 * @brief Destroy the Piece object
+					 */
+					virtual ~Piece() {}
+
+					/**
+					 * @brief Validates the move of the piece (abstract)
+					 *
+					 * @return If the move is valid (bool)
+					 */
+					virtual bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						return false;
+					}
+
+					/**
+					 * @brief Updates the coordinates of the piece
+					 *
+					 * @param x The new x coordinate of the piece (0-7)
+					 * @param y The new y coordinate of the piece (0-7)
+					 */
+					void update_coords(int x, int y) {
+						this->coords[0] = x;
+						this->coords[1] = y;
+					}
+
+					/**
+					 * @brief Get the type object
+					 * 
+					 * @return piece_type 
+					 */
+					piece_type get_type() { return this->type; }
+
+					/**
+					 * @brief Validates the move of the piece (checks if the landing square is
+					 * valid)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the landing square is valid (bool)
+					 */
+					bool validate_validation(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (board[x_final][y_final] == nullptr)
+							return true;
+						if (board[x_final][y_final]->is_white == this->is_white)
+							return false;
+						return true;
+					}
+
+					/**
+					 * @brief Checks the path from the piece to the landing square
+					 *
+					 * @param x_final The final x coordinate
+					 * @param y_final The final y coordinate
+					 * @param board The board
+					 * @return Whether the path is clear (bool)
+					 */
+					bool check_path(int x_final, int y_final, const std::array<std::array<Piece *, 8>, 8> &board) {
+						bitboards::Bitboard path = bitboards::between(bitboards::square(this->coords[0], this->coords[1]), bitboards::square(x_final, y_final));
+						while (path) {
+							int sq = bitboards::pop_lsb(path);
+							if (board[bitboards::square_x(sq)][bitboards::square_y(sq)] != nullptr)
+								return false;
+						}
+						return true;
+					}
+
+					/**
+					 * @brief Shows the piece in a readable format
+					 *
+					 * @return The formatted piece (std::string)
+					 */
+					std::string show() {
+						if (this->is_white) {
+							std::string piece_names[6] = {"P", "R", "N", "B", "Q", "K"};
+							return piece_names[this->type];
+						}
+						std::string piece_names[6] = {"p", "r", "n", "b", "q", "k"};
+						return piece_names[this->type];
+					}
+			};
+
+			/**
+			 * @brief The pawn piece (inherits from Piece)
+			 *
+			 */
+			class Pawn : public Piece {
+				private:
+					/**
+					 * @brief If the pawn has moved
+					 *
+					 */
+					bool has_moved = false;
+
+				public:
+					/**
+					 * @brief Construct a new Pawn object
+					 *
+					 * @param is_white Whether the pawn is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the pawn
+					 * @param y The y coordinate of the pawn
+					 */
+					Pawn(bool is_white, int x, int y) : Piece(p, is_white, x, y){}
+
+					/**
+					 * @brief Validates the move of the pawn (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (this->is_white)
+							return this->validate<Color::white>(board, x_final, y_final);
+						return this->validate<Color::black>(board, x_final, y_final);
+					}
+
+				private:
+					/**
+					 * @brief Validates the move of a pawn of a given color
+					 *
+					 * @tparam Us The color of the pawn
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					template <Color Us>
+					bool validate(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						typedef ColorTraits<Us> side;
+						int from = bitboards::square(this->coords[0], this->coords[1]);
+						int to = bitboards::square(x_final, y_final);
+						if (bitboards::pawn_attacks(side::white, from) & bitboards::bit(to))
+							return board[x_final][y_final] != nullptr && board[x_final][y_final]->is_white != side::white;
+						int push = from + side::forward;
+						if (push < 0 || push > 63 || board[bitboards::square_x(push)][this->coords[1]] != nullptr)
+							return false;
+						if (to == push)
+							return true;
+						if (this->coords[0] == side::pawn_rank && to == push + side::forward)
+							return board[x_final][y_final] == nullptr;
+						return false;
+					}
+			};
+
+			/**
+			 * @brief The rook piece (inherits from Piece)
+			 *
+			 */
+			class Rook : public Piece {
+				private:
+					/**
+					 * @brief If the rook has moved
+					 *
+					 */
+					bool has_moved = false;
+
+				public:
+					/**
+					 * @brief Construct a new Rook object
+					 *
+					 * @param is_white Whether the rook is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the rook
+					 * @param y The y coordinate of the rook
+					 */
+					Rook(bool is_white, int x, int y) : Piece(r, is_white, x, y) {}
+
+					/**
+					 * @brief Validates the move of the rook (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (bitboards::rook_rays(bitboards::square(this->coords[0], this->coords[1])) & bitboards::bit(bitboards::square(x_final, y_final))) {
+							if (validate_validation(board, x_final, y_final))
+								return this->check_path(x_final, y_final, board);
+						}
+						return false;
+					}
+			};
+
+			/**
+			 * @brief The knight piece (inherits from Piece)
+			 *
+			 */
+			class Knight : public Piece {
+				public:
+					/**
+					 * @brief Construct a new Knight object
+					 *
+					 * @param is_white Whether the knight is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the knight
+					 * @param y The y coordinate of the knight
+					 */
+					Knight(bool is_white, int x, int y) : Piece(n, is_white, x, y) {}
+
+					/**
+					 * @brief Validates the move of the knight (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (bitboards::knight_attacks(bitboards::square(this->coords[0], this->coords[1])) & bitboards::bit(bitboards::square(x_final, y_final)))
+							return validate_validation(board, x_final, y_final);
+						return false;
+					}
+			};
+
+			/**
+			 * @brief The bishop piece (inherits from Piece)
+			 *
+			 */
+			class Bishop : public Piece {
+				public:
+					/**
+					 * @brief Construct a new Bishop object
+					 *
+					 * @param is_white Whether the bishop is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the bishop
+					 * @param y The y coordinate of the bishop
+					 */
+					Bishop(bool is_white, int x, int y) : Piece(b, is_white, x, y) {}
+
+					/**
+					 * @brief Validates the move of the bishop (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (bitboards::bishop_rays(bitboards::square(this->coords[0], this->coords[1])) & bitboards::bit(bitboards::square(x_final, y_final))) {
+							if (validate_validation(board, x_final, y_final))
+								return this->check_path(x_final, y_final, board);
+						}
+						return false;
+					}
+			};
+
+			/**
+			 * @brief The queen piece (inherits from Piece)
+			 *
+			 */
+			class Queen : public Piece {
+				public:
+					/**
+					 * @brief Construct a new Queen object
+					 *
+					 * @param is_white Whether the queen is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the queen
+					 * @param y The y coordinate of the queen
+					 */
+					Queen(bool is_white, int x, int y) : Piece(q, is_white, x, y) {}
+
+					/**
+					 * @brief Validates the move of the queen (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if ((bitboards::rook_rays(bitboards::square(this->coords[0], this->coords[1])) | bitboards::bishop_rays(bitboards::square(this->coords[0], this->coords[1]))) & bitboards::bit(bitboards::square(x_final, y_final))) {
+							if (validate_validation(board, x_final, y_final))
+								return this->check_path(x_final, y_final, board);
+						}
+						return false;
+					}
+			};
+
+			/**
+			 * @brief The king piece (inherits from Piece)
+			 *
+			 */
+			class King : public Piece {
+				private:
+					/**
+					 * @brief Whether the king has moved or not
+					 *
+					 */
+					bool has_moved = false;
+
+				public:
+					/**
+					 * @brief Construct a new King object
+					 *
+					 * @param is_white Whether the king is white or black (true = white, false =
+					 * black)
+					 * @param x The x coordinate of the king
+					 * @param y The y coordinate of the king
+					 */
+					King(bool is_white, int x, int y) : Piece(k, is_white, x, y) {}
+
+					/**
+					 * @brief Validates the move of the king (combines the other validation
+					 * functions)
+					 *
+					 * @param board The board
+					 * @param x_final The x coordinate of the landing square
+					 * @param y_final The y coordinate of the landing square
+					 * @return If the move is valid (bool)
+					 */
+					bool validation_function(const std::array<std::array<Piece *, 8>, 8> &board, int x_final, int y_final) {
+						if (bitboards::king_attacks(bitboards::square(this->coords[0], this->coords[1])) & bitboards::bit(bitboards::square(x_final, y_final)))
+							return validate_validation(board, x_final, y_final);
+						return false;
+					}
+			};
+		} // namespace pieces
+
+		/**
+		 * @brief A move packed in 16 bits (bits 0-5 = start square, bits 6-11 = end
+		 * square, bits 12-13 = promotion piece, bits 14-15 = flag)
+		 */
+		class PackedMove {
+			private:
+				/**
+				 * @brief The packed move
+				 */
+				uint16_t data;
+
+			public:
+				/**
+				 * @brief The kind of move (stored in the flag bits)
+				 */
+				enum move_flag { normal_move, promotion_move, en_passant_move, castling_move };
+
+				/**
+				 * @brief Construct a new PackedMove object (uninitialized, so that move lists
+				 * cost nothing to create)
+				 */
+				PackedMove() = default;
+
+				/**
+				 * @brief Construct a new PackedMove object
+				 *
+				 * @param from The start square
+				 * @param to The end square
+				 * @param flag The kind of move (refer to the move_flag enum)
+				 * @param promotion The type of the piece to promote to (only used by
+				 * promotions, refer to the pieces::piece_type enum)
+				 */
+				PackedMove(int from, int to, int flag = normal_move, int promotion = pieces::piece_type::n) {
+					int code = promotion == pieces::piece_type::b ? 1 : promotion == pieces::piece_type::r ? 2 : promotion == pieces::piece_type::q ? 3 : 0;
+					this->data = uint16_t(from | to << 6 | code << 12 | flag << 14);
+				}
+
+				/**
+				 * @brief Builds a move from its packed value (refer to raw)
+				 *
+				 * @param raw The packed move
+				 * @return The move (PackedMove)
+				 */
+				static PackedMove from_raw(uint16_t raw) {
+					PackedMove move;
+					move.data = raw;
+					return move;
+				}
+
+				/**
+				 * @brief Gets the start square
+				 *
+				 * @return The start square (int)
+				 */
+				int from() const { return this->data & 63; }
+
+				/**
+				 * @brief Gets the end square
+				 *
+				 * @return The end square (int)
+				 */
+				int to() const { return (this->data >> 6) & 63; }
+
+				/**
+				 * @brief Gets the kind of move
+				 *
+				 * @return The flag (refer to the move_flag enum)
+				 */
+				int flag() const { return this->data >> 14; }
+
+				/**
+				 * @brief Gets the type of the piece to promote to
+				 *
+				 * @return The piece type (refer to the pieces::piece_type enum, -1 if the
+				 * move is not a promotion)
+				 */
+				int promotion() const {
+					const int types[4] = {pieces::piece_type::n, pieces::piece_type::b, pieces::piece_type::r, pieces::piece_type::q};
+					return this->flag() == promotion_move ? types[(this->data >> 12) & 3] : -1;
+				}
+
+				/**
+				 * @brief Gets the packed move
+				 *
+				 * @return The 16 bits of the move (uint16_t)
+				 */
+				uint16_t raw() const { return this->data; }
+
+				/**
+				 * @brief Checks if the move is equal to another move
+				 *
+				 * @param other The other move
+				 * @return Whether the moves are equal (bool)
+				 */
+				bool operator==(const PackedMove &other) const { return this->data == other.data; }
+
+				/**
+				 * @brief Checks if the move is not equal to another move
+				 *
+				 * @param other The other move
+				 * @return Whether the moves are not equal (bool)
+				 */
+				bool operator!=(const PackedMove &other) const { return this->data != other.data; }
+
+				/**
+				 * @brief Converts the move to a Move object
+				 *
+				 * @return The move (PlayeChessEngine::Move)
+				 */
+				PlayeChessEngine::Move to_move() const {
+					PlayeChessEngine::Move move = PlayeChessEngine::Move(bitboards::square_x(this->from()), bitboards::square_y(this->from()), bitboards::square_x(this->to()), bitboards::square_y(this->to()));
+					move.set_promotion(this->promotion());
+					return move;
+				}
+
+				/**
+				 * @brief Shows the move in long algebraic notation (e.g. e2e4, e7e8q)
+				 *
+				 * @return Formatted move (std::string)
+				 */
+				std::string notation() const { return this->to_move().notation(); }
+		};
+
+		/**
+		 * @brief A list of moves with a fixed capacity, stored inline (no allocation)
+		 */
+		class MoveList {
+			private:
+				/**
+				 * @brief The moves (only the first count are set)
+				 */
+				std::array<PackedMove, 256> moves;
+				/**
+				 * @brief The number of moves
+				 */
+				int count = 0;
+
+			public:
+				/**
+				 * @brief Adds a move at the end of the list
+				 *
+				 * @param move The move
+				 */
+				void push_back(PackedMove move) { this->moves[this->count++] = move; }
+
+				/**
+				 * @brief Gets the number of moves
+				 *
+				 * @return The number of moves (int)
+				 */
+				int size() const { return this->count; }
+
+				/**
+				 * @brief Checks if the list is empty
+				 *
+				 * @return If there is no move (bool)
+				 */
+				bool empty() const { return this->count == 0; }
+
+				/**
+				 * @brief Removes all the moves
+				 */
+				void clear() { this->count = 0; }
+
+				/**
+				 * @brief Gets a move
+				 *
+				 * @param i The index of the move
+				 * @return The move (PackedMove&)
+				 */
+				PackedMove &operator[](int i) { return this->moves[i]; }
+
+				/**
+				 * @brief Gets a move
+				 *
+				 * @param i The index of the move
+				 * @return The move (PackedMove)
+				 */
+				PackedMove operator[](int i) const { return this->moves[i]; }
+
+				/**
+				 * @brief Gets the first move (for range based loops)
+				 *
+				 * @return A pointer to the first move (PackedMove*)
+				 */
+				PackedMove *begin() { return this->moves.data(); }
+
+				/**
+				 * @brief Gets the end of the moves (for range based loops)
+				 *
+				 * @return A pointer past the last move (PackedMove*)
+				 */
+				PackedMove *end() { return this->moves.data() + this->count; }
+		};
+
+		/**
+		 * @brief The information needed to undo a move (returned by Board::make_move)
+		 *
+		 */
+		struct UndoInfo {
+			/**
+			 * @brief The start square of the move
+			 */
+			int from = 0;
+			/**
+			 * @brief The end square of the move
+			 */
+			int to = 0;
+			/**
+			 * @brief The square of the captured piece (differs from the end square for en
+			 * passant)
+			 */
+			int captured_square = 0;
+			/**
+			 * @brief The moved piece (mailbox code)
+			 */
+			int8_t moved = -1;
+			/**
+			 * @brief The captured piece (mailbox code, -1 if there was no capture)
+			 */
+			int8_t captured = -1;
+			/**
+			 * @brief The castling rights before the move
+			 */
+			int castling_rights = 0;
+			/**
+			 * @brief The en passant square before the move
+			 */
+			int en_passant_square = -1;
+			/**
+			 * @brief The halfmove clock before the move
+			 */
+			int halfmove_clock = 0;
+			/**
+			 * @brief The zobrist key before the move
+			 */
+			uint64_t key = 0;
+		};
+
+		/**
+		 * @brief The moves a generation stage produces (tactical moves are the captures,
+		 * en passant and all the promotions, quiet moves are the others and castling)
+		 */
+		enum move_stage { all_moves, tactical_moves, quiet_moves };
+
+		/**
+		 * @brief The checks and pins of the side to move, computed once per position
+		 * by the legal move generator
+		 *
+		 */
+		struct LegalMasks {
+			/**
+			 * @brief The square of the king (-1 if there is no king)
+			 */
+			int king = -1;
+			/**
+			 * @brief The enemy pieces giving check
+			 */
+			bitboards::Bitboard checkers = 0;
+			/**
+			 * @brief The own pieces pinned to the king
+			 */
+			bitboards::Bitboard pinned = 0;
+			/**
+			 * @brief The squares where a non king move must land (the checker and the
+			 * squares between it and the king, every square if there is no check)
+			 */
+			bitboards::Bitboard check_mask = ~bitboards::Bitboard(0);
+		};
+
+		/**
+		 * @brief The board class
+		 *
+		 */
+		class Board {
+			private:
+				/**
+				 * @brief The bitboards of the pieces (indexed by color then piece type, 0 =
+				 * white, 1 = black)
+				 *
+				 */
+				std::array<std::array<bitboards::Bitboard, 6>, 2> pieces_bb = {};
+
+				/**
+				 * @brief The bitboards of all the pieces of a color (0 = white, 1 = black)
+				 *
+				 */
+				std::array<bitboards::Bitboard, 2> colors_bb = {};
+
+				/**
+				 * @brief The bitboard of all the pieces
+				 *
+				 */
+				bitboards::Bitboard occupied_bb = 0;
+
+				/**
+				 * @brief The piece on each square (-1 if empty, piece type for white, piece
+				 * type + 6 for black)
+				 *
+				 */
+				std::array<int8_t, 64> mailbox;
+
+				/**
+				 * @brief The castling rights (1 = white kingside, 2 = white queenside, 4 =
+				 * black kingside, 8 = black queenside)
+				 *
+				 */
+				int castling_rights = 0;
+
+				/**
+				 * @brief The board (compatibility view of the bitboards, rebuilt on demand)
+				 *
+				 */
+				std::array<std::array<pieces::Piece *, 8>, 8> board = {{
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+					{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}
+				}};
+
+				/**
+				 * @brief Whether the board view is out of date with the bitboards
+				 *
+				 */
+				bool view_dirty = true;
+
+				/**
+				 * @brief The moves played to get to this position
+				 *
+				 */
+				std::vector<Move> moves;
+
+				/**
+				 * @brief Whether it is white's turn or not
+				 *
+				 */
+				bool white_turn = true;
+
+				/**
+				 * @brief The square a pawn can capture en passant on (-1 if none)
+				 *
+				 */
+				int en_passant_square = -1;
+
+				/**
+				 * @brief The number of halfmoves since the last capture or pawn move
+				 *
+				 */
+				int halfmove_clock = 0;
+
+				/**
+				 * @brief The number of the current move (starts at 1, incremented after
+				 * black plays)
+				 *
+				 */
+				int fullmove_number = 1;
+
+				/**
+				 * @brief The moves played with Board::move (to take them back)
+				 *
+				 */
+				std::vector<UndoInfo> played;
+
+				/**
+				 * @brief The zobrist key of the position (updated on every change)
+				 *
+				 */
+				uint64_t key = 0;
+
+				/**
+				 * @brief The zobrist keys of the positions before this one (one per move
+				 * played with make_move)
+				 *
+				 */
+				std::vector<uint64_t> key_history;
+
+				/**
+				 * @brief The number of pieces of each mailbox code (updated on every change)
+				 *
+				 */
+				std::array<int, 12> piece_counts = {};
+
+				/**
+				 * @brief The material and square scores of the pieces in the middlegame and
+				 * in the endgame, from white's point of view (updated on every change)
+				 *
+				 */
+				int middlegame_score = 0;
+				int endgame_score = 0;
+
+				/**
+				 * @brief The game phase (refer to evaluation::phase_weights, updated on every
+				 * change)
+				 *
+				 */
+				int phase = 0;
+
+				/**
+				 * @brief Gets the bitboard index of a color
+				 *
+				 * @param white If the color is white
+				 * @return The index (0 = white, 1 = black) (int)
+				 */
+				static int color_index(bool white) { return white ? 0 : 1; }
+
+				/**
+				 * @brief Gets the castling right bit of a side
+				 *
+				 * @param white If the player is white
+				 * @param kingside Wether it is kingside or queenside
+				 * @return The castling right bit (int)
+				 */
+				static int castling_bit(bool white, bool kingside) {
+					return (white ? 1 : 4) << (kingside ? 0 : 1);
+				}
+
+				/**
+				 * @brief Gets the castling rights lost when a piece leaves or lands on a
+				 * square
+				 *
+				 * @param sq The square
+				 * @return The castling rights lost (int)
+				 */
+				static int castling_loss(int sq) {
+					switch (sq) {
+						case 0: return 2;
+						case 4: return 3;
+						case 7: return 1;
+						case 56: return 8;
+						case 60: return 12;
+						case 63: return 4;
+						default: return 0;
+					}
+				}
+
+				/**
+				 * @brief Gets the type of the piece on a (non empty) square
+				 *
+				 * @param sq The square
+				 * @return The piece type (pieces::piece_type)
+				 */
+				pieces::piece_type type_on(int sq) const { return pieces::piece_type(this->mailbox[sq] % 6); }
+
+				/**
+				 * @brief Gets the color of the piece on a (non empty) square
+				 *
+				 * @param sq The square
+				 * @return If the piece is white (bool)
+				 */
+				bool white_on(int sq) const { return this->mailbox[sq] < 6; }
+
+				/**
+				 * @brief Puts a piece on an empty square
+				 *
+				 * @param sq The square
+				 * @param white If the piece is white
+				 * @param type The type of the piece
+				 */
+				void put_piece(int sq, bool white, pieces::piece_type type) {
+					bitboards::Bitboard b = bitboards::bit(sq);
+					this->pieces_bb[color_index(white)][type] |= b;
+					this->colors_bb[color_index(white)] |= b;
+					this->occupied_bb |= b;
+					int code = type + (white ? 0 : 6);
+					this->mailbox[sq] = code;
+					this->key ^= zobrist::keys.pieces[code][sq];
+					this->piece_counts[code]++;
+					this->middlegame_score += evaluation::square_scores.middlegame[code][sq];
+					this->endgame_score += evaluation::square_scores.endgame[code][sq];
+					this->phase += evaluation::phase_weights[type];
+					this->view_dirty = true;
+				}
+
+				/**
+				 * @brief Removes the piece of a square (if any)
+				 *
+				 * @param sq The square
+				 */
+				void remove_piece(int sq) {
+					if (this->mailbox[sq] < 0)
+						return;
+					bitboards::Bitboard b = bitboards::bit(sq);
+					this->pieces_bb[color_index(this->white_on(sq))][this->type_on(sq)] &= ~b;
+					this->colors_bb[color_index(this->white_on(sq))] &= ~b;
+					this->occupied_bb &= ~b;
+					int code = this->mailbox[sq];
+					this->key ^= zobrist::keys.pieces[code][sq];
+					this->piece_counts[code]--;
+					this->middlegame_score -= evaluation::square_scores.middlegame[code][sq];
+					this->endgame_score -= evaluation::square_scores.endgame[code][sq];
+					this->phase -= evaluation::phase_weights[code % 6];
+					this->mailbox[sq] = -1;
+					this->view_dirty = true;
+				}
+
+				/**
+				 * @brief Validates the move of the piece on a square (without checking if it
+				 * puts the king in check)
+				 *
+				 * @param from The start square
+				 * @param to The landing square
+				 * @return If the move is valid (bool)
+				 */
+				bool is_pseudo_legal(int from, int to) {
+					if (this->mailbox[from] < 0 || from == to)
+						return false;
+					return this->destinations(from) & bitboards::bit(to);
+				}
+
+				/**
+				 * @brief Gets the landing squares of the piece on a square (without checking
+				 * if the moves put the king in check)
+				 *
+				 * @param from The start square
+				 * @return The landing squares (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard destinations(int from) {
+					if (this->mailbox[from] < 0)
+						return 0;
+					bool white = this->white_on(from);
+					switch (this->type_on(from)) {
+						case pieces::piece_type::p: {
+							bitboards::Bitboard push = bitboards::pawn_pushes(white, from) & ~this->occupied_bb;
+							if (push && bitboards::square_x(from) == (white ? 1 : 6))
+								push |= bitboards::pawn_pushes(white, bitboards::lsb(push)) & ~this->occupied_bb;
+							bitboards::Bitboard captures = this->colors_bb[color_index(!white)];
+							if (this->en_passant_square >= 0 && bitboards::square_x(this->en_passant_square) == (white ? 5 : 2))
+								captures |= bitboards::bit(this->en_passant_square);
+							return push | (bitboards::pawn_attacks(white, from) & captures);
+						}
+						case pieces::piece_type::n:
+							return bitboards::knight_attacks(from) & ~this->colors_bb[color_index(white)];
+						case pieces::piece_type::k:
+							return bitboards::king_attacks(from) & ~this->colors_bb[color_index(white)];
+						case pieces::piece_type::r:
+							return bitboards::rook_attacks(from, this->occupied_bb) & ~this->colors_bb[color_index(white)];
+						case pieces::piece_type::b:
+							return bitboards::bishop_attacks(from, this->occupied_bb) & ~this->colors_bb[color_index(white)];
+						default:
+							return bitboards::queen_attacks(from, this->occupied_bb) & ~this->colors_bb[color_index(white)];
+					}
+				}
+
+				/**
+				 * @brief Converts a move to the squares it uses
+				 *
+				 * @param move The move
+				 * @param from The start square (output)
+				 * @param to The end square (output)
+				 */
+				static void move_squares(const PlayeChessEngine::Move &move, int &from, int &to) {
+					from = move.get_start_square();
+					to = move.get_end_square();
+				}
+
+				/**
+				 * @brief Computes the zobrist key of the position from scratch
+				 *
+				 * @return The key (uint64_t)
+				 */
+				uint64_t compute_key() {
+					uint64_t key = zobrist::keys.castling[this->castling_rights];
+					if (!this->white_turn)
+						key ^= zobrist::keys.side;
+					if (this->en_passant_square >= 0)
+						key ^= zobrist::keys.en_passant[bitboards::square_y(this->en_passant_square)];
+					bitboards::Bitboard occupied = this->occupied_bb;
+					while (occupied) {
+						int sq = bitboards::pop_lsb(occupied);
+						key ^= zobrist::keys.pieces[this->mailbox[sq]][sq];
+					}
+					return key;
+				}
+
+				/**
+				 * @brief Computes the checkers, pinned pieces and check mask of a color
+				 *
+				 * @tparam Us The color
+				 * @return The masks (LegalMasks)
+				 */
+				template <Color Us>
+				LegalMasks legal_masks() const {
+					typedef ColorTraits<Us> side;
+					LegalMasks masks;
+					bitboards::Bitboard king = this->pieces_bb[side::index][pieces::piece_type::k];
+					if (!king)
+						return masks;
+					masks.king = bitboards::lsb(king);
+					const std::array<bitboards::Bitboard, 6> &enemy = this->pieces_bb[1 - side::index];
+					masks.checkers = this->attackers_to(masks.king) & this->colors_bb[1 - side::index];
+					bitboards::Bitboard snipers = (bitboards::rook_rays(masks.king) & (enemy[pieces::piece_type::r] | enemy[pieces::piece_type::q]))
+						| (bitboards::bishop_rays(masks.king) & (enemy[pieces::piece_type::b] | enemy[pieces::piece_type::q]));
+					while (snipers) {
+						bitboards::Bitboard blockers = bitboards::between(masks.king, bitboards::pop_lsb(snipers)) & this->occupied_bb;
+						if (bitboards::popcount(blockers) == 1 && (blockers & this->colors_bb[side::index]))
+							masks.pinned |= blockers;
+					}
+					if (masks.checkers)
+						masks.check_mask = bitboards::popcount(masks.checkers) > 1 ? 0 : masks.checkers | bitboards::between(masks.king, bitboards::lsb(masks.checkers));
+					return masks;
+				}
+
+				/**
+				 * @brief Adds the pawn moves landing on a set of squares (with the four
+				 * promotions on the last row)
+				 *
+				 * @tparam Us The color of the pawns
+				 * @tparam Offset The offset from the start square to the landing square
+				 * @param list The list
+				 * @param targets The landing squares
+				 */
+				template <Color Us, int Offset>
+				static void add_pawn_targets(MoveList &list, bitboards::Bitboard targets) {
+					typedef ColorTraits<Us> side;
+					while (targets) {
+						int to = bitboards::pop_lsb(targets);
+						if (bitboards::square_x(to) != side::promotion_rank) {
+							list.push_back(PackedMove(to - Offset, to));
+							continue;
+						}
+						for (int promotion : {pieces::piece_type::q, pieces::piece_type::r, pieces::piece_type::b, pieces::piece_type::n})
+							list.push_back(PackedMove(to - Offset, to, PackedMove::promotion_move, promotion));
+					}
+				}
+
+				/**
+				 * @brief Adds the moves of a set of pawns (shifting the whole set at once,
+				 * pinned pawns are done one by one)
+				 *
+				 * @tparam Us The color of the pawns
+				 * @tparam Stage The moves to generate (refer to the move_stage enum)
+				 * @param list The list
+				 * @param masks The checks and pins of the color
+				 * @param legal If the en passant captures that put the king in check are
+				 * skipped
+				 * @param pawns The pawns
+				 */
+				template <Color Us, move_stage Stage>
+				void add_pawn_moves(MoveList &list, const LegalMasks &masks, bool legal, bitboards::Bitboard pawns) {
+					typedef ColorTraits<Us> side;
+					bitboards::Bitboard empty = ~this->occupied_bb;
+					bitboards::Bitboard enemies = this->colors_bb[1 - side::index];
+					bitboards::Bitboard free = pawns & ~masks.pinned;
+					bitboards::Bitboard single = bitboards::shift<side::forward>(free) & empty;
+					// Pushes to the last row are promotions, so they are tactical moves
+					bitboards::Bitboard push_mask = Stage == all_moves ? ~bitboards::Bitboard(0) : Stage == tactical_moves ? bitboards::row(side::promotion_rank) : ~bitboards::row(side::promotion_rank);
+					add_pawn_targets<Us, side::forward>(list, single & masks.check_mask & push_mask);
+					if constexpr (Stage != tactical_moves) {
+						bitboards::Bitboard twice = bitboards::shift<side::forward>(single & bitboards::row(side::double_push_rank)) & empty;
+						add_pawn_targets<Us, 2 * side::forward>(list, twice & masks.check_mask);
+					}
+					if constexpr (Stage != quiet_moves) {
+						add_pawn_targets<Us, side::forward - 1>(list, bitboards::shift<side::forward - 1>(free & ~bitboards::column(0)) & enemies & masks.check_mask);
+						add_pawn_targets<Us, side::forward + 1>(list, bitboards::shift<side::forward + 1>(free & ~bitboards::column(7)) & enemies & masks.check_mask);
+					}
+					bitboards::Bitboard pinned = pawns & masks.pinned;
+					while (pinned) {
+						int from = bitboards::pop_lsb(pinned);
+						bitboards::Bitboard targets = this->destinations(from) & masks.check_mask & bitboards::line(masks.king, from);
+						if (this->en_passant_square >= 0)
+							targets &= ~bitboards::bit(this->en_passant_square);
+						if constexpr (Stage == tactical_moves)
+							targets &= enemies | bitboards::row(side::promotion_rank);
+						else if constexpr (Stage == quiet_moves)
+							targets &= empty & ~bitboards::row(side::promotion_rank);
+						while (targets) {
+							int to = bitboards::pop_lsb(targets);
+							if (bitboards::square_x(to) != side::promotion_rank) {
+								list.push_back(PackedMove(from, to));
+								continue;
+							}
+							for (int promotion : {pieces::piece_type::q, pieces::piece_type::r, pieces::piece_type::b, pieces::piece_type::n})
+								list.push_back(PackedMove(from, to, PackedMove::promotion_move, promotion));
+						}
+					}
+					if (Stage == quiet_moves || this->en_passant_square < 0 || bitboards::square_x(this->en_passant_square) != side::en_passant_rank)
+						return;
+					bitboards::Bitboard capturers = bitboards::pawn_attacks(!side::white, this->en_passant_square) & pawns;
+					while (capturers) {
+						PackedMove move = PackedMove(bitboards::pop_lsb(capturers), this->en_passant_square, PackedMove::en_passant_move);
+						if (!legal || !this->leaves_in_check(move, side::white))
+							list.push_back(move);
+					}
+				}
+
+				/**
+				 * @brief Adds the moves of a set of pieces of a given type (not pawns or
+				 * kings)
+				 *
+				 * @tparam Type The type of the pieces
+				 * @param list The list
+				 * @param masks The checks and pins of the color
+				 * @param pieces The pieces
+				 * @param targets The squares the pieces can land on (not own pieces and in
+				 * the check mask)
+				 */
+				template <pieces::piece_type Type>
+				void add_piece_type_moves(MoveList &list, const LegalMasks &masks, bitboards::Bitboard pieces, bitboards::Bitboard targets) {
+					while (pieces) {
+						int from = bitboards::pop_lsb(pieces);
+						bitboards::Bitboard attacks;
+						if constexpr (Type == pieces::piece_type::n)
+							attacks = bitboards::knight_attacks(from);
+						else if constexpr (Type == pieces::piece_type::b)
+							attacks = bitboards::bishop_attacks(from, this->occupied_bb);
+						else if constexpr (Type == pieces::piece_type::r)
+							attacks = bitboards::rook_attacks(from, this->occupied_bb);
+						else
+							attacks = bitboards::queen_attacks(from, this->occupied_bb);
+						attacks &= targets;
+						if (masks.pinned & bitboards::bit(from))
+							attacks &= bitboards::line(masks.king, from);
+						while (attacks)
+							list.push_back(PackedMove(from, bitboards::pop_lsb(attacks)));
+					}
+				}
+
+				/**
+				 * @brief Adds the king moves (and castling)
+				 *
+				 * @tparam Us The color of the king
+				 * @tparam Stage The moves to generate (refer to the move_stage enum)
+				 * @param list The list
+				 * @param masks The checks and pins of the color
+				 * @param legal If the moves to attacked squares are skipped
+				 * @param kings The kings
+				 */
+				template <Color Us, move_stage Stage>
+				void add_king_moves(MoveList &list, const LegalMasks &masks, bool legal, bitboards::Bitboard kings) {
+					typedef ColorTraits<Us> side;
+					while (kings) {
+						int from = bitboards::pop_lsb(kings);
+						bitboards::Bitboard targets = bitboards::king_attacks(from) & ~this->colors_bb[side::index];
+						if constexpr (Stage == tactical_moves)
+							targets &= this->colors_bb[1 - side::index];
+						else if constexpr (Stage == quiet_moves)
+							targets &= ~this->occupied_bb;
+						while (targets) {
+							int to = bitboards::pop_lsb(targets);
+							if (legal && (this->attackers_to(to, this->occupied_bb ^ bitboards::bit(from)) & this->colors_bb[1 - side::index]))
+								continue;
+							list.push_back(PackedMove(from, to));
+						}
+						if (Stage == tactical_moves || !legal || masks.checkers || from != bitboards::square(side::back_rank, 4))
+							continue;
+						if (this->can_castle<Us>(true))
+							list.push_back(PackedMove(from, from + 2, PackedMove::castling_move));
+						if (this->can_castle<Us>(false))
+							list.push_back(PackedMove(from, from - 2, PackedMove::castling_move));
+					}
+				}
+
+				/**
+				 * @brief Generates the moves of a color (the checks and pins are computed
+				 * once, only en passant captures are tried on the board)
+				 *
+				 * @tparam Us The color
+				 * @tparam Stage The moves to generate (refer to the move_stage enum)
+				 * @param list The list to add the moves to
+				 * @param legal If the moves that put the king in check are removed
+				 * @param from_mask The squares of the pieces to generate the moves of
+				 */
+				template <Color Us, move_stage Stage = all_moves>
+				void generate(MoveList &list, bool legal, bitboards::Bitboard from_mask) {
+					typedef ColorTraits<Us> side;
+					LegalMasks masks = legal ? this->legal_masks<Us>() : LegalMasks();
+					const std::array<bitboards::Bitboard, 6> &own = this->pieces_bb[side::index];
+					if (bitboards::popcount(masks.checkers) < 2) {
+						bitboards::Bitboard targets = ~this->colors_bb[side::index] & masks.check_mask;
+						if constexpr (Stage == tactical_moves)
+							targets &= this->colors_bb[1 - side::index];
+						else if constexpr (Stage == quiet_moves)
+							targets &= ~this->occupied_bb;
+						this->add_pawn_moves<Us, Stage>(list, masks, legal, own[pieces::piece_type::p] & from_mask);
+						this->add_piece_type_moves<pieces::piece_type::n>(list, masks, own[pieces::piece_type::n] & from_mask & ~masks.pinned, targets);
+						this->add_piece_type_moves<pieces::piece_type::b>(list, masks, own[pieces::piece_type::b] & from_mask, targets);
+						this->add_piece_type_moves<pieces::piece_type::r>(list, masks, own[pieces::piece_type::r] & from_mask, targets);
+						this->add_piece_type_moves<pieces::piece_type::q>(list, masks, own[pieces::piece_type::q] & from_mask, targets);
+					}
+					this->add_king_moves<Us, Stage>(list, masks, legal, own[pieces::piece_type::k] & from_mask);
+				}
+
+				/**
+				 * @brief Plays a move and checks if it leaves the king in check
+				 *
+				 * @param move The move
+				 * @param white If the color of the moved piece is white
+				 * @return If the king is in check after the move (bool)
+				 */
+				bool leaves_in_check(PackedMove move, bool white) {
+					UndoInfo undo = this->make_move(move);
+					bool check = this->is_check(white);
+					this->unmake_move(undo);
+					return check;
+				}
+
+				/**
+				 * @brief Creates a new piece object
+				 *
+				 * @param type The type of the piece
+				 * @param white If the piece is white
+				 * @param x The x coordinate of the piece
+				 * @param y The y coordinate of the piece
+				 * @return The piece (pieces::Piece*)
+				 */
+				static pieces::Piece *new_piece(pieces::piece_type type, bool white, int x, int y) {
+					switch (type) {
+						case pieces::piece_type::p:
+							return new pieces::Pawn(white, x, y);
+						case pieces::piece_type::r:
+							return new pieces::Rook(white, x, y);
+						case pieces::piece_type::n:
+							return new pieces::Knight(white, x, y);
+						case pieces::piece_type::b:
+							return new pieces::Bishop(white, x, y);
+						case pieces::piece_type::q:
+							return new pieces::Queen(white, x, y);
+						default:
+							return new pieces::King(white, x, y);
+					}
+				}
+
+				/**
+				 * @brief Deletes the pieces of the board view
+				 *
+				 */
+				void clear_view() {
+					for (auto &row : this->board) {
+						for (auto &piece : row) {
+							delete piece;
+							piece = nullptr;
+						}
+					}
+					this->view_dirty = true;
+				}
+
+				/**
+				 * @brief Rebuilds the board view from the bitboards (if it is out of date)
+				 *
+				 */
+				void update_view() {
+					if (!this->view_dirty)
+						return;
+					this->clear_view();
+					bitboards::Bitboard occupied = this->occupied_bb;
+					while (occupied) {
+						int sq = bitboards::pop_lsb(occupied);
+						int x = bitboards::square_x(sq);
+						int y = bitboards::square_y(sq);
+						pieces::Piece *piece = new_piece(this->type_on(sq), this->white_on(sq), x, y);
+						if (piece->get_type() == pieces::piece_type::k)
+							piece->has_moved = !(this->castling_rights & castling_bit(piece->is_white, true)) && !(this->castling_rights & castling_bit(piece->is_white, false));
+						else if (piece->get_type() == pieces::piece_type::r && (y == 0 || y == 7))
+							piece->has_moved = !(this->castling_rights & castling_bit(piece->is_white, y == 7)) || x != (piece->is_white ? 0 : 7);
+						this->board[x][y] = piece;
+					}
+					this->view_dirty = false;
+				}
+
+				/**
+				 * @brief Copies the position of another board (the board view is not shared)
+				 *
+				 * @param other The other board
+				 */
+				void copy_position(const Board &other) {
+					this->pieces_bb = other.pieces_bb;
+					this->colors_bb = other.colors_bb;
+					this->occupied_bb = other.occupied_bb;
+					this->mailbox = other.mailbox;
+					this->castling_rights = other.castling_rights;
+					this->moves = other.moves;
+					this->white_turn = other.white_turn;
+					this->en_passant_square = other.en_passant_square;
+					this->halfmove_clock = other.halfmove_clock;
+					this->fullmove_number = other.fullmove_number;
+					this->played = other.played;
+					this->key = other.key;
+					this->key_history = other.key_history;
+					this->piece_counts = other.piece_counts;
+					this->middlegame_score = other.middlegame_score;
+					this->endgame_score = other.endgame_score;
+					this->phase = other.phase;
+					this->view_dirty = true;
+				}
+
+				/**
+				 * @brief Removes every piece and resets the state of the position
+				 */
+				void clear_position() {
+					this->pieces_bb = {};
+					this->colors_bb = {};
+					this->occupied_bb = 0;
+					this->mailbox.fill(-1);
+					this->castling_rights = 0;
+					this->white_turn = true;
+					this->en_passant_square = -1;
+					this->halfmove_clock = 0;
+					this->fullmove_number = 1;
+					this->key = 0;
+					this->key_history.clear();
+					this->piece_counts = {};
+					this->middlegame_score = 0;
+					this->endgame_score = 0;
+					this->phase = 0;
+					this->played.clear();
+					this->view_dirty = true;
+				}
+
+				/**
+				 * @brief Reads a number in a fen string
+				 *
+				 * @param fen The fen string
+				 * @param i The position of the first digit (moved past the last digit)
+				 * @return The number (-1 if there is no digit or it is too big) (int)
+				 */
+				static int parse_number(std::string_view fen, size_t &i) {
+					size_t start = i;
+					long number = 0;
+					while (i < fen.size() && fen[i] >= '0' && fen[i] <= '9' && i - start < 9)
+						number = number * 10 + (fen[i++] - '0');
+					if (i == start || (i < fen.size() && fen[i] >= '0' && fen[i] <= '9'))
+						return -1;
+					return int(number);
+				}
+
+			public:
+				/**
+				 * @brief Construct a new Board object
+				 *
+				 * @param fen The fen string (refer to load_fen)
+				 */
+				Board(std::string_view fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {
+					this->load_fen(fen);
+				};
 
 				/**
-				 * @brief The moves played to get to this position
+				 * @brief Construct a new Board object from another board (the pieces of the
+				 * board view are not shared)
 				 *
+				 * @param other The other board
 				 */
-				std::vector<Move> moves;
+				Board(const Board &other) {
+					this->copy_position(other);
+				}
 
 				/**
-				 * @brief Whether it is white's turn or not
+				 * @brief Copies another board (the pieces of the board view are not shared)
 				 *
+				 * @param other The other board
+				 * @return This board (Board&)
 				 */
-				bool white_turn = true;
+				Board &operator=(const Board &other) {
+					if (this != &other) {
+						this->clear_view();
+						this->copy_position(other);
+					}
+					return *this;
+				}
 
-			public:
-				// TODO Add the funcitonnality for "KQkq - 0 1"
 				/**
-				 * @brief Construct a new Board object
+				 * @brief Destroy the Board object
 				 *
-				 * @param fen The fen string
 				 */
-				Board(std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {
-					size_t fen_end = fen.find(" ");
-					fen = fen.substr(0, fen_end);
-					this->white_turn = fen[fen_end + 1] == 'w';
-					this->load_fen(fen);
-				};
-				
+				~Board() {
+					this->clear_view();
+				}
+
 				/**
 				 * @brief Set the moves vector
-				 * 
+				 *
 				 * @param moves The new value of the moves vector
 				 */
 				void set_moves(std::vector<Move> moves) {
@@ -648,42 +2456,65 @@ namespace PlayeChessEngine {
 
 				/**
 				 * @brief Set the white_turn value
-				 * 
+				 *
 				 * @param white_turn The new value of white_turn
 				 */
 				void set_white_turn(bool white_turn) {
+					if (white_turn != this->white_turn)
+						this->key ^= zobrist::keys.side;
 					this->white_turn = white_turn;
 				}
 
+				/**
+				 * @brief Gets whose turn it is
+				 *
+				 * @return If it is white's turn (bool)
+				 */
+				bool is_white_turn() const {
+					return this->white_turn;
+				}
+
+				/**
+				 * @brief Gets the number of halfmoves since the last capture or pawn move
+				 *
+				 * @return The halfmove clock (int)
+				 */
+				int get_halfmove_clock() const {
+					return this->halfmove_clock;
+				}
+
+				/**
+				 * @brief Gets the number of the current move (starts at 1)
+				 *
+				 * @return The fullmove number (int)
+				 */
+				int get_fullmove_number() const {
+					return this->fullmove_number;
+				}
+
+				/**
+				 * @brief Gets the zobrist key of the position (pieces, side to move, castling
+				 * rights and en passant file)
+				 *
+				 * @return The key (uint64_t)
+				 */
+				uint64_t get_key() const {
+					return this->key;
+				}
+
 				/**
 				 * @brief Checks if the board is equal to another board
-				 * 
+				 *
 				 * @param other The other board
 				 * @return Whether the boards are equal (bool)
 				 */
 				bool operator==(Board &other) {
-					for (int i = 0; i < 8; i++) {
-						for (int j = 0; j < 8; j++) {
-							if (this->board[i][j] == nullptr && other.board[i][j] == nullptr) {
-								continue;
-							} if (this->board[i][j] == nullptr || other.board[i][j] == nullptr) {
-								return false;
-							}
-							if(this->board[i][j]->get_type() == other.board[i][j]->get_type() && this->board[i][j]->is_white == other.board[i][j]->is_white)
-								continue;
-							return false;
-						}
-					}
-					if(this->can_castle(true, true) != other.can_castle(true, true) || this->can_castle(true, false) != other.can_castle(true, false) || this->can_castle(false, true) != other.can_castle(false, true) || this->can_castle(false, false) != other.can_castle(false, false))
-						return false;
-					if(this->get_en_passant(this->moves, this->white_turn) != other.get_en_passant(other.moves, other.white_turn))
-						return false;
-					return true;
+					return this->key == other.key && this->pieces_bb == other.pieces_bb;
 				}
-				
+
 				/**
 				 * @brief Checks if the board is not equal to another board
-				 * 
+				 *
 				 * @param other The other board
 				 * @return Whether the boards are not equal (bool)
 				 */
@@ -692,78 +2523,208 @@ namespace PlayeChessEngine {
 				}
 
 				/**
-				 * @brief Reverses the fen string (for loading the board)
+				 * @brief Loads the board from a fen string in a single pass (the fields after
+				 * the placement are optional: white to move, castling rights deduced from
+				 * the kings and rooks, no en passant, clocks at 0 1)
 				 *
 				 * @param fen The fen string
-				 * @return The reversed fen (std::string)
+				 * @throw std::invalid_argument If the fen is not valid (the board is then
+				 * left empty)
 				 */
-				std::string reverse_fen(std::string fen) {
-					std::vector<std::string> fen_split;
-					std::string rt = "";
-					std::string buffer = "";
-					for (auto c : fen) {
+				void load_fen(std::string_view fen) {
+					this->clear_position();
+					size_t i = 0;
+					auto fail = [&](const char *reason) {
+						this->clear_position();
+						throw std::invalid_argument("Invalid fen (" + std::string(reason) + " at character " + std::to_string(i) + "): " + std::string(fen));
+					};
+					auto separator = [&]() {
+						if (i >= fen.size())
+							return false;
+						if (fen[i] != ' ' || i + 1 >= fen.size())
+							fail("expected a space followed by a field");
+						i++;
+						return true;
+					};
+					int x = 7;
+					int y = 0;
+					for (; i < fen.size() && fen[i] != ' '; i++) {
+						char c = fen[i];
 						if (c == '/') {
-							fen_split.push_back(buffer + '/');
-							buffer = "";
+							if (y != 8 || x == 0)
+								fail("wrong number of squares in a row");
+							x--;
+							y = 0;
+						} else if (c >= '1' && c <= '8') {
+							y += c - '0';
+							if (y > 8)
+								fail("too many squares in a row");
+						} else {
+							size_t type = std::string_view("prnbqk").find(char(c | 0x20));
+							if (type == std::string_view::npos)
+								fail("unknown piece");
+							if (y >= 8)
+								fail("too many squares in a row");
+							if (type == pieces::piece_type::p && (x == 0 || x == 7))
+								fail("pawn on the first or last row");
+							this->put_piece(bitboards::square(x, y++), c < 'a', pieces::piece_type(type));
+						}
+					}
+					if (x != 0 || y != 8)
+						fail("wrong number of squares");
+					for (int color = 0; color < 2; color++) {
+						if (bitboards::popcount(this->pieces_bb[color][pieces::piece_type::k]) != 1)
+							fail("each color needs exactly one king");
+					}
+					bool castling_given = false;
+					if (separator()) {
+						if (fen[i] != 'w' && fen[i] != 'b')
+							fail("side to move must be w or b");
+						this->white_turn = fen[i++] == 'w';
+					}
+					if (separator()) {
+						castling_given = true;
+						if (fen[i] == '-') {
+							i++;
+						} else {
+							for (; i < fen.size() && fen[i] != ' '; i++) {
+								size_t right = std::string_view("KQkq").find(fen[i]);
+								if (right == std::string_view::npos || (this->castling_rights & (1 << right)))
+									fail("unknown or repeated castling right");
+								bool white = right < 2;
+								int row = white ? 0 : 7;
+								if (!(this->pieces_bb[color_index(white)][pieces::piece_type::k] & bitboards::bit(bitboards::square(row, 4))) || !(this->pieces_bb[color_index(white)][pieces::piece_type::r] & bitboards::bit(bitboards::square(row, right % 2 == 0 ? 7 : 0))))
+									fail("castling right without its king and rook");
+								this->castling_rights |= 1 << right;
+							}
+						}
+					}
+					if (separator()) {
+						if (fen[i] == '-') {
+							i++;
 						} else {
-							buffer += c;
+							int row = this->white_turn ? 5 : 2;
+							if (i + 1 >= fen.size() || fen[i] < 'a' || fen[i] > 'h' || fen[i + 1] != '1' + row)
+								fail("en passant square must be - or on the third or sixth row");
+							int sq = bitboards::square(row, fen[i] - 'a');
+							int pushed = sq + (this->white_turn ? -8 : 8);
+							if (this->mailbox[pushed] != pieces::piece_type::p + (this->white_turn ? 6 : 0) || (this->occupied_bb & (bitboards::bit(sq) | bitboards::bit(sq - pushed + sq))))
+								fail("en passant square without the pawn that was pushed");
+							if (bitboards::pawn_attacks(!this->white_turn, sq) & this->pieces_bb[color_index(this->white_turn)][pieces::piece_type::p])
+								this->en_passant_square = sq;
+							i += 2;
 						}
 					}
-					fen_split.push_back(buffer + '/');
-					for (int i = fen_split.size() - 1; i >= 0; i--) {
-						rt += fen_split[i];
+					if (separator()) {
+						this->halfmove_clock = parse_number(fen, i);
+						if (this->halfmove_clock < 0)
+							fail("halfmove clock must be a number");
+					}
+					if (separator()) {
+						this->fullmove_number = parse_number(fen, i);
+						if (this->fullmove_number < 1)
+							fail("fullmove number must be a positive number");
 					}
-					return rt.substr(0, rt.size() - 1);
+					if (i < fen.size())
+						fail("unexpected characters after the fen");
+					if (!castling_given) {
+						for (int row = 0; row < 8; row += 7) {
+							bool white = row == 0;
+							if (!(this->pieces_bb[color_index(white)][pieces::piece_type::k] & bitboards::bit(bitboards::square(row, 4))))
+								continue;
+							if (this->pieces_bb[color_index(white)][pieces::piece_type::r] & bitboards::bit(bitboards::square(row, 7)))
+								this->castling_rights |= castling_bit(white, true);
+							if (this->pieces_bb[color_index(white)][pieces::piece_type::r] & bitboards::bit(bitboards::square(row, 0)))
+								this->castling_rights |= castling_bit(white, false);
+						}
+					}
+					if (this->is_check(!this->white_turn))
+						fail("the side not to move is in check");
+					this->key = this->compute_key();
 				}
 
 				/**
-				 * @brief Loads the board from a fen string
+				 * @brief Writes the fen string of the position into a buffer (null
+				 * terminated; at most 71 chars of placement, 7 of side, castling and en
+				 * passant, 5 spaces and two int clocks of up to 10 digits, so 128 chars
+				 * are always enough)
 				 *
-				 * @param fen The fen string
+				 * @param buffer The buffer
+				 * @param size The size of the buffer
+				 * @return The length of the fen (0 if the buffer is too small) (size_t)
 				 */
-				void load_fen(std::string fen) {
-					fen = reverse_fen(fen);
-					int x = 0;
-					int y = 0;
-					for (auto c : fen) {
-					if (c == '/') {
-						y = 0;
-						x++;
-					} else if (c == '8') {
-						continue;
-					} else if (c >= '0' && c <= '9') {
-						y += c - '0';
-					} else {
-						bool is_white = c >= 'A' && c <= 'Z';
-						switch (c) {
-							case 'p':
-							case 'P':
-								this->board[x][y] = new pieces::Pawn(is_white, x, y);
-								break;
-							case 'r':
-							case 'R':
-								this->board[x][y] = new pieces::Rook(is_white, x, y);
-								break;
-							case 'n':
-							case 'N':
-								this->board[x][y] = new pieces::Knight(is_white, x, y);
-								break;
-							case 'b':
-							case 'B':
-								this->board[x][y] = new pieces::Bishop(is_white, x, y);
-								break;
-							case 'q':
-							case 'Q':
-								this->board[x][y] = new pieces::Queen(is_white, x, y);
-								break;
-							case 'k':
-							case 'K':
-								this->board[x][y] = new pieces::King(is_white, x, y);
-								break;
+				size_t to_fen(char *buffer, size_t size) const {
+					size_t length = 0;
+					auto put = [&](char c) {
+						if (length < size)
+							buffer[length] = c;
+						length++;
+					};
+					auto put_number = [&](int number) {
+						char digits[12];
+						int count = 0;
+						do {
+							digits[count++] = char('0' + number % 10);
+							number /= 10;
+						} while (number > 0);
+						while (count > 0)
+							put(digits[--count]);
+					};
+					for (int x = 7; x >= 0; x--) {
+						int empty = 0;
+						for (int y = 0; y < 8; y++) {
+							int code = this->mailbox[bitboards::square(x, y)];
+							if (code < 0) {
+								empty++;
+								continue;
+							}
+							if (empty > 0)
+								put(char('0' + empty));
+							empty = 0;
+							put("PRNBQKprnbqk"[code]);
 						}
-						y++;
+						if (empty > 0)
+							put(char('0' + empty));
+						if (x > 0)
+							put('/');
+					}
+					put(' ');
+					put(this->white_turn ? 'w' : 'b');
+					put(' ');
+					if (this->castling_rights == 0)
+						put('-');
+					for (int right = 0; right < 4; right++) {
+						if (this->castling_rights & (1 << right))
+							put("KQkq"[right]);
+					}
+					put(' ');
+					if (this->en_passant_square < 0) {
+						put('-');
+					} else {
+						put(char('a' + bitboards::square_y(this->en_passant_square)));
+						put(char('1' + bitboards::square_x(this->en_passant_square)));
 					}
+					put(' ');
+					put_number(this->halfmove_clock);
+					put(' ');
+					put_number(this->fullmove_number);
+					if (length >= size) {
+						if (size > 0)
+							buffer[0] = '\0';
+						return 0;
 					}
+					buffer[length] = '\0';
+					return length;
+				}
+
+				/**
+				 * @brief Gets the fen string of the position
+				 *
+				 * @return The fen (std::string)
+				 */
+				std::string to_fen() const {
+					char buffer[128];
+					return std::string(buffer, this->to_fen(buffer, sizeof(buffer)));
 				}
 
 				/**
@@ -772,15 +2733,15 @@ namespace PlayeChessEngine {
 				 * @param moves The moves to highlight
 				 * @param board The board to print
 				 */
-				void print_board(std::vector<std::vector<int>> moves = {}, std::array<std::array<pieces::Piece *, 8>, 8> board = {}) {
+				void print_board(const std::vector<std::array<int, 2>> &moves = {}, std::array<std::array<pieces::Piece *, 8>, 8> board = {}) {
 					if (board == std::array<std::array<pieces::Piece *, 8>, 8>{})
-						board = this->board;
+						board = this->get_board();
 					std::cout << "  #-----------------#" << std::endl;
 					for (int i = 0; i < 8; i++) {
 						std::cout << 8 - i << " | ";
 						for (int j = 0; j < 8; j++) {
 							bool skip = false;
-							for (auto move : moves) {
+							for (const auto &move : moves) {
 								if (move[0] == 7 - i && move[1] == j) {
 									std::cout << "* ";
 									skip = true;
@@ -801,11 +2762,13 @@ namespace PlayeChessEngine {
 				}
 
 				/**
-				 * @brief Gets the board
+				 * @brief Gets the board (view of the bitboards, the pieces are owned by the
+				 * board and stay valid until the position changes)
 				 *
 				 * @return The board (std::array<std::array<pieces::Piece*, 8>, 8>)
 				 */
 				std::array<std::array<pieces::Piece *, 8>, 8> get_board() {
+					this->update_view();
 					return this->board;
 				}
 
@@ -816,7 +2779,144 @@ namespace PlayeChessEngine {
 				 * @param y The y coordinate
 				 * @return The piece (pieces::Piece*)
 				 */
-				pieces::Piece *get_piece(int x, int y) { return this->board[x][y]; }
+				pieces::Piece *get_piece(int x, int y) {
+					this->update_view();
+					return this->board[x][y];
+				}
+
+				/**
+				 * @brief Gets the bitboard of the pieces of a type and color
+				 *
+				 * @param white If the color is white
+				 * @param type The type of the pieces
+				 * @return The bitboard (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard get_pieces(bool white, pieces::piece_type type) const {
+					return this->pieces_bb[color_index(white)][type];
+				}
+
+				/**
+				 * @brief Gets the bitboard of all the pieces of a color
+				 *
+				 * @param white If the color is white
+				 * @return The bitboard (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard get_pieces(bool white) const {
+					return this->colors_bb[color_index(white)];
+				}
+
+				/**
+				 * @brief Gets the bitboard of all the pieces
+				 *
+				 * @return The bitboard (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard get_occupied() const {
+					return this->occupied_bb;
+				}
+
+				/**
+				 * @brief Gets the piece on a square without building the board view
+				 *
+				 * @param sq The square
+				 * @return The mailbox code (type, + 6 for black, -1 if the square is empty)
+				 * (int)
+				 */
+				int get_piece_code(int sq) const {
+					return this->mailbox[sq];
+				}
+
+				/**
+				 * @brief Generates the moves of a piece (the checks and pins are computed
+				 * once, only en passant captures are tried on the board)
+				 *
+				 * @param from The square of the piece
+				 * @param legal If the moves that put the king in check are removed
+				 * @return The moves (MoveList)
+				 */
+				MoveList generate_piece_moves(int from, bool legal = true) {
+					MoveList list;
+					if (this->mailbox[from] < 0)
+						return list;
+					if (this->white_on(from))
+						this->generate<Color::white>(list, legal, bitboards::bit(from));
+					else
+						this->generate<Color::black>(list, legal, bitboards::bit(from));
+					return list;
+				}
+
+				/**
+				 * @brief Generates all the moves of a color (the checks and pins are computed
+				 * once, only en passant captures are tried on the board)
+				 *
+				 * @param white If the color is white
+				 * @param legal If the moves that put the king in check are removed
+				 * @return The moves (MoveList)
+				 */
+				MoveList generate_moves(bool white, bool legal = true) {
+					MoveList list;
+					if (white)
+						this->generate<Color::white>(list, legal, ~bitboards::Bitboard(0));
+					else
+						this->generate<Color::black>(list, legal, ~bitboards::Bitboard(0));
+					return list;
+				}
+
+				/**
+				 * @brief Generates the legal moves of one stage for the side to move (so that
+				 * a search can stop after the captures without generating the quiet moves)
+				 *
+				 * @param list The list to add the moves to
+				 * @param stage The moves to generate (refer to the move_stage enum)
+				 */
+				void generate_stage(MoveList &list, move_stage stage) {
+					bitboards::Bitboard all = ~bitboards::Bitboard(0);
+					if (this->white_turn) {
+						if (stage == tactical_moves)
+							this->generate<Color::white, tactical_moves>(list, true, all);
+						else if (stage == quiet_moves)
+							this->generate<Color::white, quiet_moves>(list, true, all);
+						else
+							this->generate<Color::white>(list, true, all);
+					} else {
+						if (stage == tactical_moves)
+							this->generate<Color::black, tactical_moves>(list, true, all);
+						else if (stage == quiet_moves)
+							this->generate<Color::black, quiet_moves>(list, true, all);
+						else
+							this->generate<Color::black>(list, true, all);
+					}
+				}
+
+				/**
+				 * @brief Checks if a move (e.g. from a hash table) is legal for the side to
+				 * move without generating the moves (the move is played once if it is
+				 * pseudo legal)
+				 *
+				 * @param move The move
+				 * @return If the move is legal (bool)
+				 */
+				bool is_legal_move(PackedMove move) {
+					int from = move.from(), to = move.to();
+					if (this->mailbox[from] < 0 || this->white_on(from) != this->white_turn || from == to)
+						return false;
+					// Only promotions use the promotion bits (the other moves are stored with 0)
+					if (move.flag() != PackedMove::promotion_move && (move.raw() >> 12) & 3)
+						return false;
+					bool white = this->white_turn;
+					pieces::piece_type type = this->type_on(from);
+					bool castling = type == pieces::piece_type::k && abs(to - from) == 2;
+					if (castling != (move.flag() == PackedMove::castling_move))
+						return false;
+					if (castling)
+						return from == (white ? 4 : 60) && this->can_castle(white, to > from);
+					bool en_passant = type == pieces::piece_type::p && to == this->en_passant_square;
+					bool promotion = type == pieces::piece_type::p && bitboards::square_x(to) == (white ? 7 : 0);
+					if (en_passant != (move.flag() == PackedMove::en_passant_move) || promotion != (move.flag() == PackedMove::promotion_move))
+						return false;
+					if (!(this->destinations(from) & bitboards::bit(to)))
+						return false;
+					return !this->leaves_in_check(move, white);
+				}
 
 				/**
 				 * @brief Gets the moves for a piece
@@ -829,59 +2929,36 @@ namespace PlayeChessEngine {
 				 */
 				std::vector<PlayeChessEngine::Move> get_moves(int x, int y, bool from_premove = false) {
 					std::vector<PlayeChessEngine::Move> moves;
-					for (int i = 0; i < 8; i++) {
-						for (int j = 0; j < 8; j++) {
-							if (this->board[x][y] == nullptr)
-								continue;
-							if (this->board[x][y]->validation_function(this->board, i, j)) {
-								PlayeChessEngine::Move move = PlayeChessEngine::Move(x, y, i, j);
-                                // std::cout << "Move of " << this->board[x][y]->show() << " from " << x << ", " << y << " to " << i << ", " << j << std::endl;
-								if (from_premove) {
-									moves.push_back(move);
-									continue;
-								}
-								if (!this->premove_check(move, this->board[x][y]->is_white)) {
-									moves.push_back(move);
-								}
-							}
-						}
-					}
+					for (auto move : this->generate_piece_moves(bitboards::square(x, y), !from_premove))
+						moves.push_back(move.to_move());
 					return moves;
 				}
 
 				/**
 				 * @brief Gets all the moves for a color
 				 *
+				 * @param brd The board (unused, kept for compatibility)
 				 * @param white If the color is white
 				 * @param from_premove If the function is called from premove_check (to
 				 * prevent infinite recursion)
 				 * @return The moves (std::vector<PlayeChessEngine::Move>)
 				 */
-				std::vector<PlayeChessEngine::Move> get_all_moves(std::array<std::array<pieces::Piece *, 8>, 8> brd, bool white, bool from_premove = false) {
+				std::vector<PlayeChessEngine::Move> get_all_moves([[maybe_unused]] const std::array<std::array<pieces::Piece *, 8>, 8> &brd, bool white, bool from_premove = false) {
 					std::vector<PlayeChessEngine::Move> moves;
-					for (int i = 0; i < 8; i++) {
-						for (int j = 0; j < 8; j++) {
-							if (brd[i][j] == nullptr)
-								continue;
-							if (brd[i][j]->is_white != white)
-								continue;
-							for (auto move : this->get_moves(i, j, from_premove)) {
-								moves.push_back(move);
-							}
-						}
-					}
+					for (auto move : this->generate_moves(white, !from_premove))
+						moves.push_back(move.to_move());
 					return moves;
 				}
 
 				/**
 				 * @brief Checks if a vector of int is in a vector of vector of int
-				 * 
+				 *
 				 * @param vec The vector of vector of int
 				 * @param val The vector of int
 				 * @return Wether the vector of int is in the vector of vector of int (bool)
 				 */
-				bool in(std::vector<std::vector<int>> vec, std::vector<int> val) {
-					for (auto v : vec) {
+				bool in(const std::vector<std::array<int, 2>> &vec, std::array<int, 2> val) {
+					for (const auto &v : vec) {
 						if (v == val)
 							return true;
 					}
@@ -889,109 +2966,334 @@ namespace PlayeChessEngine {
 				}
 
 				/**
-				 * @brief Get the all landing moves of a color
-				 * 
-				 * @param brd The board
-				 * @param white Wether the color is white
-				 * @param from_premove If the function call is from premove_check (to prevent infinite recursion)
-				 * @return All landing moves (std::vector<std::vector<int>>) 
+				 * @brief Get the all landing moves of a color
+				 *
+				 * @param brd The board
+				 * @param white Wether the color is white
+				 * @param from_premove If the function call is from premove_check (to prevent infinite recursion)
+				 * @return All landing moves (std::vector<std::array<int, 2>>)
+				 */
+				std::vector<std::array<int, 2>> get_all_landing_moves(const std::array<std::array<pieces::Piece *, 8>, 8> &brd, bool white, bool from_premove = false) {
+					std::vector<std::array<int, 2>> moves;
+					for(auto move : this->get_all_moves(brd, white, from_premove)) {
+						moves.push_back(move.get_end_coords());
+					}
+					return moves;
+				}
+
+				/**
+				 * @brief Gets the pieces (of both colors) attacking a square, looking outward
+				 * from the square with the attacks of each piece type
+				 *
+				 * @param sq The square
+				 * @param occupied The occupied squares (sliders are blocked by them)
+				 * @return The attacking pieces (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard attackers_to(int sq, bitboards::Bitboard occupied) const {
+					bitboards::Bitboard rooks = this->pieces_bb[0][pieces::piece_type::r] | this->pieces_bb[1][pieces::piece_type::r] | this->pieces_bb[0][pieces::piece_type::q] | this->pieces_bb[1][pieces::piece_type::q];
+					bitboards::Bitboard bishops = this->pieces_bb[0][pieces::piece_type::b] | this->pieces_bb[1][pieces::piece_type::b] | this->pieces_bb[0][pieces::piece_type::q] | this->pieces_bb[1][pieces::piece_type::q];
+					return (bitboards::pawn_attacks(false, sq) & this->pieces_bb[0][pieces::piece_type::p])
+						| (bitboards::pawn_attacks(true, sq) & this->pieces_bb[1][pieces::piece_type::p])
+						| (bitboards::knight_attacks(sq) & (this->pieces_bb[0][pieces::piece_type::n] | this->pieces_bb[1][pieces::piece_type::n]))
+						| (bitboards::king_attacks(sq) & (this->pieces_bb[0][pieces::piece_type::k] | this->pieces_bb[1][pieces::piece_type::k]))
+						| (bitboards::rook_attacks(sq, occupied) & rooks)
+						| (bitboards::bishop_attacks(sq, occupied) & bishops);
+				}
+
+				/**
+				 * @brief Gets the pieces (of both colors) attacking a square
+				 *
+				 * @param sq The square
+				 * @return The attacking pieces (bitboards::Bitboard)
+				 */
+				bitboards::Bitboard attackers_to(int sq) const {
+					return this->attackers_to(sq, this->occupied_bb);
+				}
+
+				/**
+				 * @brief Checks if a square is attacked by a color (stops at the first
+				 * attacker found)
+				 *
+				 * @param sq The square
+				 * @param by_white If the attacking color is white
+				 * @return If the square is attacked (bool)
+				 */
+				bool is_square_attacked(int sq, bool by_white) const {
+					if (by_white)
+						return this->is_square_attacked<Color::white>(sq);
+					return this->is_square_attacked<Color::black>(sq);
+				}
+
+				/**
+				 * @brief Checks if a square is attacked by a color (stops at the first
+				 * attacker found)
+				 *
+				 * @tparam By The attacking color
+				 * @param sq The square
+				 * @return If the square is attacked (bool)
+				 */
+				template <Color By>
+				bool is_square_attacked(int sq) const {
+					const std::array<bitboards::Bitboard, 6> &attacker = this->pieces_bb[ColorTraits<By>::index];
+					if (bitboards::pawn_attacks(!ColorTraits<By>::white, sq) & attacker[pieces::piece_type::p])
+						return true;
+					if (bitboards::knight_attacks(sq) & attacker[pieces::piece_type::n])
+						return true;
+					if (bitboards::king_attacks(sq) & attacker[pieces::piece_type::k])
+						return true;
+					if (bitboards::rook_attacks(sq, this->occupied_bb) & (attacker[pieces::piece_type::r] | attacker[pieces::piece_type::q]))
+						return true;
+					return bitboards::bishop_attacks(sq, this->occupied_bb) & (attacker[pieces::piece_type::b] | attacker[pieces::piece_type::q]);
+				}
+
+				/**
+				 * @brief Checks if a color is in check
+				 *
+				 * @param white If the color is white
+				 * @return If the color is in check (bool)
+				 */
+				bool is_check(bool white) {
+					if (white)
+						return this->is_check<Color::white>();
+					return this->is_check<Color::black>();
+				}
+
+				/**
+				 * @brief Checks if a color is in check
+				 *
+				 * @tparam Us The color
+				 * @return If the color is in check (bool)
+				 */
+				template <Color Us>
+				bool is_check() const {
+					bitboards::Bitboard king = this->pieces_bb[ColorTraits<Us>::index][pieces::piece_type::k];
+					if (!king)
+						return false;
+					return this->is_square_attacked<ColorTraits<Us>::them>(bitboards::lsb(king));
+				}
+
+				/**
+				 * @brief Transfer a piece from a position to another
+				 *
+				 * @param board The board to transfer the piece on
+				 * @param start_x The x coordinate of the start position
+				 * @param start_y The y coordinate of the start position
+				 * @param end_x The x coordinate of the end position
+				 * @param end_y The y coordinate of the end position
+				 * @return Board with the piece positon updated
+				 * (std::array<std::array<pieces::Piece*, 8>, 8>)
+				 */
+				std::array<std::array<pieces::Piece *, 8>, 8> transfer(std::array<std::array<pieces::Piece *, 8>, 8> board, int start_x, int start_y, int end_x, int end_y) {
+					std::swap(board[start_x][start_y], board[end_x][end_y]);
+					board[start_x][start_y] = nullptr;
+					return board;
+				}
+
+				/**
+				 * @brief Plays one move in the future to check if it puts the king in check
+				 *
+				 * @param move The move to check
+				 * @param white If the color is white
+				 * @return If the move is legal (bool)
+				 */
+				bool premove_check(PlayeChessEngine::Move move, bool white) {
+					int from, to;
+					move_squares(move, from, to);
+					if (this->mailbox[from] < 0)
+						throw std::invalid_argument("No piece at start coords");
+					return this->leaves_in_check(this->pack(move), white);
+				}
+
+				/**
+				 * @brief Packs a move (finding its kind from the position)
+				 *
+				 * @param move The move
+				 * @return The packed move (PackedMove)
+				 */
+				PackedMove pack(PlayeChessEngine::Move move) {
+					int from, to;
+					move_squares(move, from, to);
+					if (move.get_promotion() >= 0)
+						return PackedMove(from, to, PackedMove::promotion_move, move.get_promotion());
+					if (this->mailbox[from] >= 0 && this->type_on(from) == pieces::piece_type::k && abs(to - from) == 2)
+						return PackedMove(from, to, PackedMove::castling_move);
+					if (this->mailbox[from] >= 0 && this->type_on(from) == pieces::piece_type::p && to == this->en_passant_square)
+						return PackedMove(from, to, PackedMove::en_passant_move);
+					return PackedMove(from, to);
+				}
+
+				/**
+				 * @brief Plays a move on the board, only touching the squares it uses (the
+				 * move is not validated, castling is a king move of two squares)
+				 *
+				 * @param move The move to play
+				 * @return The information needed to undo the move (UndoInfo)
+				 */
+				UndoInfo make_move(PlayeChessEngine::Move move) {
+					return this->make_move(this->pack(move));
+				}
+
+				/**
+				 * @brief Plays a packed move on the board, only touching the squares it uses
+				 * (the move is not validated)
+				 *
+				 * @param move The move to play
+				 * @return The information needed to undo the move (UndoInfo)
 				 */
-				std::vector<std::vector<int>> get_all_landing_moves(std::array<std::array<pieces::Piece *, 8>, 8> brd, bool white, bool from_premove = false) {
-					std::vector<std::vector<int>> moves;
-					for(auto move : this->get_all_moves(brd, white, from_premove)) {
-						moves.push_back(move.get_end_coords());
+				UndoInfo make_move(PackedMove move) {
+					UndoInfo undo;
+					undo.from = move.from();
+					undo.to = move.to();
+					undo.moved = this->mailbox[undo.from];
+					undo.captured_square = undo.to;
+					undo.castling_rights = this->castling_rights;
+					undo.en_passant_square = this->en_passant_square;
+					undo.halfmove_clock = this->halfmove_clock;
+					undo.key = this->key;
+					this->key_history.push_back(this->key);
+					bool white = this->white_on(undo.from);
+					pieces::piece_type type = this->type_on(undo.from);
+					this->halfmove_clock++;
+					if (type == pieces::piece_type::p)
+						this->halfmove_clock = 0;
+					if (move.flag() == PackedMove::en_passant_move)
+						undo.captured_square = undo.to + (white ? -8 : 8);
+					undo.captured = this->mailbox[undo.captured_square];
+					if (undo.captured >= 0) {
+						this->remove_piece(undo.captured_square);
+						this->halfmove_clock = 0;
 					}
-					return moves;
+					this->remove_piece(undo.from);
+					if (move.flag() == PackedMove::promotion_move)
+						this->put_piece(undo.to, white, pieces::piece_type(move.promotion()));
+					else
+						this->put_piece(undo.to, white, type);
+					if (move.flag() == PackedMove::castling_move) {
+						int rook_from = undo.to > undo.from ? undo.from + 3 : undo.from - 4;
+						int rook_to = (undo.from + undo.to) / 2;
+						this->remove_piece(rook_from);
+						this->put_piece(rook_to, white, pieces::piece_type::r);
+					}
+					this->castling_rights &= ~(castling_loss(undo.from) | castling_loss(undo.to));
+					this->key ^= zobrist::keys.castling[undo.castling_rights] ^ zobrist::keys.castling[this->castling_rights];
+					if (this->en_passant_square >= 0)
+						this->key ^= zobrist::keys.en_passant[bitboards::square_y(this->en_passant_square)];
+					this->en_passant_square = -1;
+					if (type == pieces::piece_type::p && abs(undo.to - undo.from) == 16) {
+						int skipped = (undo.from + undo.to) / 2;
+						if (bitboards::pawn_attacks(white, skipped) & this->pieces_bb[color_index(!white)][pieces::piece_type::p]) {
+							this->en_passant_square = skipped;
+							this->key ^= zobrist::keys.en_passant[bitboards::square_y(skipped)];
+						}
+					}
+					if (!white)
+						this->fullmove_number++;
+					this->white_turn = !white;
+					this->key ^= zobrist::keys.side;
+					return undo;
 				}
 
 				/**
-				 * @brief Checks if a color is in check
+				 * @brief Undoes a move played with make_move (must be the last move played)
 				 *
-				 * @param white If the color is white
-				 * @return If the color is in check (bool)
+				 * @param undo The information returned by make_move
 				 */
-				bool is_check(bool white) {
-					for (auto move : this->get_all_moves(this->board, !white, true)) {
-						if (this->board[move.get_end_coords()[0]][move.get_end_coords()[1]] == nullptr)
-							continue;
-						if (this->board[move.get_end_coords()[0]][move.get_end_coords()[1]] ->get_type() == pieces::piece_type::k)
-							return true;
+				void unmake_move(UndoInfo undo) {
+					bool white = undo.moved < 6;
+					pieces::piece_type type = pieces::piece_type(undo.moved % 6);
+					this->remove_piece(undo.to);
+					this->put_piece(undo.from, white, type);
+					if (undo.captured >= 0)
+						this->put_piece(undo.captured_square, undo.captured < 6, pieces::piece_type(undo.captured % 6));
+					if (type == pieces::piece_type::k && abs(undo.to - undo.from) == 2) {
+						int rook_from = undo.to > undo.from ? undo.from + 3 : undo.from - 4;
+						int rook_to = (undo.from + undo.to) / 2;
+						this->remove_piece(rook_to);
+						this->put_piece(rook_from, white, pieces::piece_type::r);
 					}
-					return false;
+					this->castling_rights = undo.castling_rights;
+					this->en_passant_square = undo.en_passant_square;
+					this->halfmove_clock = undo.halfmove_clock;
+					this->key = undo.key;
+					this->key_history.pop_back();
+					if (!white)
+						this->fullmove_number--;
+					this->white_turn = white;
 				}
 
 				/**
-				 * @brief Transfer a piece from a position to another
+				 * @brief Takes back the last move played with Board::move
 				 *
-				 * @param board The board to transfer the piece on
-				 * @param start_x The x coordinate of the start position
-				 * @param start_y The y coordinate of the start position
-				 * @param end_x The x coordinate of the end position
-				 * @param end_y The y coordinate of the end position
-				 * @return Board with the piece positon updated
-				 * (std::array<std::array<pieces::Piece*, 8>, 8>)
+				 * @return If there was a move to take back (bool)
 				 */
-				std::array<std::array<pieces::Piece *, 8>, 8> transfer(std::array<std::array<pieces::Piece *, 8>, 8> board, int start_x, int start_y, int end_x, int end_y) {
-					std::swap(board[start_x][start_y], board[end_x][end_y]);
-					board[start_x][start_y] = nullptr;
-					return board;
+				bool takeback() {
+					if (this->played.empty())
+						return false;
+					this->unmake_move(this->played.back());
+					this->played.pop_back();
+					if (!this->moves.empty())
+						this->moves.pop_back();
+					return true;
 				}
 
 				/**
-				 * @brief Plays one move in the future to check if it puts the king in check
+				 * @brief Checks if a piece has a legal move to a square (without building a
+				 * list of moves)
 				 *
-				 * @param move The move to check
-				 * @param white If the color is white
+				 * @param from The square of the piece
+				 * @param to The landing square
 				 * @return If the move is legal (bool)
 				 */
-				bool premove_check(PlayeChessEngine::Move move, bool white) {
-					if (this->board[move.get_start_coords()[0]][move.get_start_coords()[1]] == nullptr)
-						throw std::invalid_argument("No piece at start coords");
-					std::array<std::array<pieces::Piece *, 8>, 8> backup = this->board;
-					this->board = this->transfer(this->board, move.get_start_coords()[0], move.get_start_coords()[1], move.get_end_coords()[0], move.get_end_coords()[1]);
-					bool check = this->is_check(white);
-					this->board = backup;
-					return check;
+				bool is_legal_destination(int from, int to) {
+					for (auto move : this->generate_piece_moves(from))
+						if (move.to() == to)
+							return true;
+					return false;
 				}
 
 				/**
 				 * @brief Plays a move
 				 *
+				 * @param moves The moves played before (unused, kept for compatibility)
 				 * @param move The move to play
 				 * @param white If the color is white
 				 * @return If the move was played (bool)
 				 */
-				PlayeChessEngine::Move move(std::vector<PlayeChessEngine::Move> moves, PlayeChessEngine::Move move, bool white) {
-					if (this->board[move.get_start_coords()[0]][move.get_start_coords()[1]] == nullptr) {
+				PlayeChessEngine::Move move([[maybe_unused]] const std::vector<PlayeChessEngine::Move> &moves, PlayeChessEngine::Move move, bool white) {
+					int from, to;
+					move_squares(move, from, to);
+					if (this->mailbox[from] < 0 || this->white_on(from) != white || !this->is_legal_destination(from, to)) {
 						move.set_valid(false);
 						return move;
-					} if(this->board[move.get_start_coords()[0]][move.get_start_coords()[1]]->is_white != white) {
-                        move.set_valid(false);
-						return move;
-					} if (move.am_in(this->get_moves(move.get_start_coords()[0], move.get_start_coords()[1]))) {
-						if(this->board[move.get_end_coords()[0]][move.get_end_coords()[1]] != nullptr)
-							move.set_capture(true);
-						this->board = this->transfer(this->board, move.get_start_coords()[0], move.get_start_coords()[1], move.get_end_coords()[0], move.get_end_coords()[1]);
-						this->board[move.get_end_coords()[0]][move.get_end_coords()[1]]->update_coords(move.get_end_coords()[0], move.get_end_coords()[1]);
-						delete this->board[move.get_start_coords()[0]][move.get_start_coords()[1]];
-						move.set_valid(true);
-						return move;
-					}
-					std::array<int, 2> start_coords = this->get_en_passant(moves, white);
-					if(start_coords == std::array<int, 2>{move.get_start_coords()[0], move.get_start_coords()[1]}) {
-						int side = moves.back().get_end_coords()[1] - start_coords[1];
-						int offset = (white ? 1 : -1);
-						if(move.get_end_coords()[0] == start_coords[0] + offset && move.get_end_coords()[1] == start_coords[1] + side) {
-							this->en_passant(start_coords, std::array<int, 2>{start_coords[0] + offset, start_coords[1] + side}, white);
-							move.set_valid(true);
-							move.set_capture(true);
-							return move;
-						}
 					}
-					move.set_valid(false);
+					move.set_capture((this->occupied_bb & bitboards::bit(to)) || (this->type_on(from) == pieces::piece_type::p && to == this->en_passant_square));
+					this->played.push_back(this->make_move(move));
+					move.set_valid(true);
 					return move;
 				}
 
+				/**
+				 * @brief Counts the leaf nodes of the legal move tree (used to test and
+				 * benchmark the move generation)
+				 *
+				 * @param depth The depth of the tree (in plies)
+				 * @return The number of leaf nodes (uint64_t)
+				 */
+				uint64_t perft(int depth) {
+					if (depth <= 0)
+						return 1;
+					MoveList moves = this->generate_moves(this->white_turn);
+					if (depth == 1)
+						return moves.size();
+					uint64_t nodes = 0;
+					for (auto move : moves) {
+						UndoInfo undo = this->make_move(move);
+						nodes += this->perft(depth - 1);
+						this->unmake_move(undo);
+					}
+					return nodes;
+				}
+
 				/**
 				 * @brief Gets the status of the game
 				 *
@@ -1000,7 +3302,7 @@ namespace PlayeChessEngine {
 				 * stalemate (int)
 				 */
 				int status(bool white) {
-					if (this->get_all_moves(this->board, white).size() == 0) {
+					if (this->generate_moves(white).empty()) {
 						if (this->is_check(white))
 							return 1;
 						else
@@ -1011,112 +3313,110 @@ namespace PlayeChessEngine {
 
 				/**
 				 * @brief Checks if there is insufficient material to checkmate
-				 * 
+				 *
 				 * @return If there is insufficient material (bool)
 				 */
-				bool insufficient_material() {
-					int num_knights = 0;
-					int num_bishops = 0;
-					for (auto row : this->board) {
-						for (auto piece : row) {
-							if (piece == nullptr)
-								continue;
-							switch (piece->get_type()) {
-								case pieces::piece_type::p:
-									return false;
-								case pieces::piece_type::n:
-									num_knights++;
-									break;
-								case pieces::piece_type::b:
-									num_bishops++;
-									break;
-								case pieces::piece_type::r:
-									return false;
-								case pieces::piece_type::q:
-									return false;
-									break;
-								default:
-									break;
-							}
-						}
-					}
-					if (num_knights + num_bishops < 2)
-						return true;
-					return false;
+				bool insufficient_material() const {
+					const auto &counts = this->piece_counts;
+					if (counts[pieces::piece_type::p] + counts[pieces::piece_type::r] + counts[pieces::piece_type::q] + counts[pieces::piece_type::p + 6] + counts[pieces::piece_type::r + 6] + counts[pieces::piece_type::q + 6])
+						return false;
+					return counts[pieces::piece_type::n] + counts[pieces::piece_type::b] + counts[pieces::piece_type::n + 6] + counts[pieces::piece_type::b + 6] < 2;
+				}
+
+				/**
+				 * @brief Gets the number of pieces of a color and type
+				 *
+				 * @param white If the pieces are white
+				 * @param type The type of the pieces
+				 * @return The number of pieces (int)
+				 */
+				int get_piece_count(bool white, pieces::piece_type type) const {
+					return this->piece_counts[type + (white ? 0 : 6)];
+				}
+
+				/**
+				 * @brief Evaluates the position by its material and piece square tables,
+				 * interpolated between the middlegame and the endgame scores by the game
+				 * phase (the terms are kept up to date by every move, so this costs a few
+				 * instructions)
+				 *
+				 * @return The score for the side to move (in centipawns) (int)
+				 */
+				int evaluate() const {
+					int phase = std::min(this->phase, evaluation::max_phase);
+					int score = (this->middlegame_score * phase + this->endgame_score * (evaluation::max_phase - phase)) / evaluation::max_phase;
+					return this->white_turn ? score : -score;
 				}
 
 				/**
 				 * @brief Checks if a player can castle
-				 * 
+				 *
 				 * @param row The row of the king (0 or 7)
 				 * @param kingside Wether to castle kingside or queenside
 				 * @return If the player can castle (bool)
 				 */
 				bool can_castle_row(int row, bool kingside) {
-					if (kingside) {
-						if (this->board[row][4] != nullptr && this->board[row][7] != nullptr && this->board[row][5] == nullptr && this->board[row][6] == nullptr) {
-							if (this->board[row][4]->get_type() == pieces::piece_type::k && this->board[row][7]->get_type() == pieces::piece_type::r && !this->board[row][4]->has_moved && !this->board[row][7]->has_moved) {
-								if (!this->is_check(this->board[row][4]->is_white)) {
-									if(!in(this->get_all_landing_moves(this->board, row != 0), {row, 5}) && !in(this->get_all_landing_moves(this->board, row != 0), {row, 6}))
-										return true;
-									return false;
-								}
-								return false;
-							}
-							return false;
-						}
+					if (row == 0)
+						return this->can_castle<Color::white>(kingside);
+					return this->can_castle<Color::black>(kingside);
+				}
+
+				/**
+				 * @brief Checks if a color can castle
+				 *
+				 * @tparam Us The color
+				 * @param kingside Wether to castle kingside or queenside
+				 * @return If the color can castle (bool)
+				 */
+				template <Color Us>
+				bool can_castle(bool kingside) const {
+					typedef ColorTraits<Us> side;
+					constexpr int king = bitboards::square(side::back_rank, 4);
+					int rook = kingside ? king + 3 : king - 4;
+					if (!(this->castling_rights & castling_bit(side::white, kingside)))
 						return false;
-					}
-					if (this->board[row][4] != nullptr && this->board[row][0] != nullptr && this->board[row][1] == nullptr && this->board[row][2] == nullptr && this->board[row][3] == nullptr) {
-						if (this->board[row][4]->get_type() == pieces::piece_type::k && this->board[row][0]->get_type() == pieces::piece_type::r && !this->board[row][4]->has_moved && !this->board[row][0]->has_moved) {
-							if (!this->is_check(this->board[row][4]->is_white)) {
-								if(!in(this->get_all_landing_moves(this->board, row != 0), {row, 1}) && !in(this->get_all_landing_moves(this->board, row != 0), {row, 2}) && !in(this->get_all_landing_moves(this->board, row != 0), {row, 3}))
-									return true;
-								return false;
-							}
-							return false;
-						}
+					if (!(this->pieces_bb[side::index][pieces::piece_type::k] & bitboards::bit(king)))
 						return false;
+					if (!(this->pieces_bb[side::index][pieces::piece_type::r] & bitboards::bit(rook)))
+						return false;
+					if (this->occupied_bb & bitboards::between(king, rook))
+						return false;
+					if (this->is_check<Us>())
+						return false;
+					bitboards::Bitboard crossed = bitboards::between(king, king + (kingside ? 3 : -3));
+					while (crossed) {
+						if (this->is_square_attacked<side::them>(bitboards::pop_lsb(crossed)))
+							return false;
 					}
-					return false;
+					return true;
 				}
 
 				/**
 				 * @brief Checks if a player can castle
-				 * 
+				 *
 				 * @param white If the player is white
 				 * @param kingside Wether to castle kingside or queenside
 				 * @return If the player can castle (bool)
 				 */
 				bool can_castle(bool white, bool kingside) {
 					if (white)
-						return this->can_castle_row(0, kingside);
-					return this->can_castle_row(7, kingside);
+						return this->can_castle<Color::white>(kingside);
+					return this->can_castle<Color::black>(kingside);
 				}
 
 				/**
 				 * @brief Castles a player
-				 * 
+				 *
 				 * @param row The row of the king (0 or 7)
 				 * @param kingside Wether to castle kingside or queenside
 				 */
 				void castle_row(int row, bool kingside) {
-					if (kingside) {
-						std::swap(this->board[row][4], this->board[row][6]);
-						std::swap(this->board[0][7], this->board[row][5]);
-						this->board[row][6]->update_coords(row, 6);
-						this->board[row][5]->update_coords(row, 5);
-					} else {
-						std::swap(this->board[row][4], this->board[row][2]);
-						std::swap(this->board[0][0], this->board[row][3]);
-						this->board[row][2]->update_coords(row, 2);
-						this->board[row][3]->update_coords(row, 3);
-					}
+					this->played.push_back(this->make_move(PlayeChessEngine::Move(row, 4, row, kingside ? 6 : 2)));
 				}
 
 				/**
 				 * @brief Castles a player
-				 * 
+				 *
 				 * @param white If the player is white
 				 * @param kingside Wether to castle kingside or queenside
 				 */
@@ -1129,35 +3429,32 @@ namespace PlayeChessEngine {
 
 				/**
 				 * @brief Checks there is a promotion on a given row
-				 * 
+				 *
 				 * @param row The row to check
 				 * @return The coordinates of promotion (or {-1, -1} if there is no promotion) (std::array<int, 2>)
 				 */
 				std::array<int, 2> get_promotion_row(int row) {
-					for (int i = 0; i < 8; i++) {
-						if (this->board[row][i] != nullptr) {
-							if(this->board[row][i]->get_type() == pieces::piece_type::p && this->board[row][i]->is_white == (row == 7))
-								return {row, i};
-						}
-					}
+					bitboards::Bitboard promoted = this->pieces_bb[color_index(row == 7)][pieces::piece_type::p] & bitboards::row(row);
+					if (promoted)
+						return {row, bitboards::square_y(bitboards::lsb(promoted))};
 					return {-1, -1};
 				}
 
 				/**
 				 * @brief Checks if a given color can castle
-				 * 
+				 *
 				 * @param white If the player is white
 				 * @return The coordinates of promotion (or {-1, -1} if there is no promotion) (std::array<int, 2>)
 				 */
 				std::array<int, 2> get_promotion(bool white) {
 					if (white)
-						return this->get_promotion_row(7);
-					return this->get_promotion_row(0);
+						return this->get_promotion_row(ColorTraits<Color::white>::promotion_rank);
+					return this->get_promotion_row(ColorTraits<Color::black>::promotion_rank);
 				}
 
 				/**
 				 * @brief Promotes a pawn
-				 * 
+				 *
 				 * @param white If the player is white
 				 * @param coords The coordinates of the pawn
 				 * @param type The type of the piece to promote to
@@ -1165,63 +3462,80 @@ namespace PlayeChessEngine {
 				void promote(bool white, std::array<int, 2> coords, pieces::piece_type type) {
 					if(coords == std::array{-1, -1})
 						return;
-					if(type == pieces::piece_type::r)
-						this->board[coords[0]][coords[1]] = new pieces::Rook(white, coords[0], coords[1]);
-					else if(type == pieces::piece_type::n)
-						this->board[coords[0]][coords[1]] = new pieces::Knight(white, coords[0], coords[1]);
-					else if(type == pieces::piece_type::b)
-						this->board[coords[0]][coords[1]] = new pieces::Bishop(white, coords[0], coords[1]);
-					else if(type == pieces::piece_type::q)
-						this->board[coords[0]][coords[1]] = new pieces::Queen(white, coords[0], coords[1]);
+					if(type == pieces::piece_type::p || type == pieces::piece_type::k)
+						return;
+					int sq = bitboards::square(coords[0], coords[1]);
+					this->remove_piece(sq);
+					this->put_piece(sq, white, type);
 				}
 
 				/**
-				 * @brief Checks if there is a threefold repetition
-				 * 
-				 * @param boards The vector of boards (after each move)
-				 * @param white If the player is white
-				 * @return Weither there is a threefold repetition (bool)
+				 * @brief Counts how many times the position occurred (only looks back to the
+				 * last capture or pawn move, which can not be repeated through)
+				 *
+				 * @return The number of occurrences, this one included (int)
 				 */
-				bool check_threefold_repetition(std::vector<Board> boards, bool white) {
+				int repetitions() const {
 					int count = 1;
-					for (int i = 0; i < boards.size() - 1; i++) {
-						if ((boards[i] == *this) && ((i % 2 == 0) != white))
+					int size = this->key_history.size();
+					int limit = std::min(this->halfmove_clock, size);
+					for (int i = 4; i <= limit; i += 2) {
+						if (this->key_history[size - i] == this->key)
 							count++;
 					}
-					return count >= 3;
+					return count;
+				}
+
+				/**
+				 * @brief Checks if the position occurred three times
+				 *
+				 * @return Weither there is a threefold repetition (bool)
+				 */
+				bool is_threefold_repetition() const {
+					return this->repetitions() >= 3;
+				}
+
+				/**
+				 * @brief Checks if there is a threefold repetition
+				 *
+				 * @param boards The vector of boards (unused, the key history is used
+				 * instead)
+				 * @param white If the player is white (unused)
+				 * @return Weither there is a threefold repetition (bool)
+				 */
+				bool check_threefold_repetition([[maybe_unused]] const std::vector<Board> &boards, [[maybe_unused]] bool white) {
+					return this->is_threefold_repetition();
 				}
 
 				/**
 				 * @brief Checks if a player can en passant on a given side
-				 * 
+				 *
 				 * @param last_move The last move
 				 * @param white If the player is white
 				 * @param side The side to check (horizontal)
 				 * @param offset The offset to check (vertical)
-				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>) 
+				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>)
 				 */
 				std::array<int, 2> get_en_passant_side(Move last_move, bool white, int side, int offset) {
 					if(last_move.get_end_coords()[1] + side < 0 || last_move.get_end_coords()[1] + side > 7)
 						return std::array<int, 2>{-1, -1};
-					if(this->board[last_move.get_end_coords()[0]][last_move.get_end_coords()[1] + side] != nullptr) {
-						pieces::Piece* ep_piece = this->board[last_move.get_end_coords()[0]][last_move.get_end_coords()[1] + side];
-						if(ep_piece->get_type() == pieces::piece_type::p && ep_piece->is_white == white)
-							return std::array<int, 2>{last_move.get_end_coords()[0], last_move.get_end_coords()[1] + side};
-					}
+					int sq = bitboards::square(last_move.get_end_coords()[0], last_move.get_end_coords()[1] + side);
+					if(this->pieces_bb[color_index(white)][pieces::piece_type::p] & bitboards::bit(sq))
+						return std::array<int, 2>{last_move.get_end_coords()[0], last_move.get_end_coords()[1] + side};
 					return std::array<int, 2>{-1, -1};
 				}
 
 				/**
 				 * @brief Checks if a player can en passant
-				 * 
+				 *
 				 * @param last_move The last move
 				 * @param white If the player is white
 				 * @param offset The offset to check (vertical)
-				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>) 
+				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>)
 				 */
 				std::array<int, 2> get_en_passant_offset(Move last_move, bool white, int offset) {
-					pieces::Piece* moved_piece = this->board[last_move.get_end_coords()[0]][last_move.get_end_coords()[1]];
-					if(last_move.get_end_coords()[0] == last_move.get_start_coords()[0] + offset && moved_piece->get_type() == pieces::piece_type::p && moved_piece->is_white != white) {
+					int sq = bitboards::square(last_move.get_end_coords()[0], last_move.get_end_coords()[1]);
+					if(last_move.get_end_coords()[0] == last_move.get_start_coords()[0] + offset && (this->pieces_bb[color_index(!white)][pieces::piece_type::p] & bitboards::bit(sq))) {
 						if(this->get_en_passant_side(last_move, white, -1, offset) != std::array<int, 2>{-1, -1})
 							return this->get_en_passant_side(last_move, white, -1, offset);
 						return this->get_en_passant_side(last_move, white, 1, offset);
@@ -1231,57 +3545,225 @@ namespace PlayeChessEngine {
 
 				/**
 				 * @brief Checks if a player can en passant
-				 * 
+				 *
 				 * @param moves The vector of moves
 				 * @param white If the player is white
-				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>) 
+				 * @return The coordinates where the player can en passant (or {-1, -1} if there is no en passant) (std::array<int, 2>)
 				 */
 				std::array<int, 2> get_en_passant(std::vector<Move> moves, bool white) {
 					if(moves.size() == 0)
 						return std::array<int, 2>{-1, -1};
 					Move last_move = moves[moves.size() -1];
 					if(white)
-						return this->get_en_passant_offset(last_move, white, -2);
-					return this->get_en_passant_offset(last_move, white, 2);
-				}
-
-				/**
-				 * @brief En passant a pawn of given color from start_coords to end_coords
-				 * 
-				 * @param start_coords The start coordinates
-				 * @param end_coords The end coordinates
-				 * @param white If the player is white
-				 */
-				void en_passant(std::array<int, 2> start_coords, std::array<int, 2> end_coords, bool white) {
-					std::swap(this->board[start_coords[0]][start_coords[1]], this->board[end_coords[0]][end_coords[1]]);
-					delete this->board[start_coords[0]][end_coords[1]];
-					this->board[end_coords[0]][end_coords[1]]->update_coords(end_coords[0], end_coords[1]);
-					this->board[start_coords[0]][end_coords[1]] = nullptr;
+						return this->get_en_passant_offset(last_move, white, -2 * ColorTraits<Color::white>::forward / 8);
+					return this->get_en_passant_offset(last_move, white, -2 * ColorTraits<Color::black>::forward / 8);
 				}
 		};
 	} // namespace board
 
 	/**
-	* @brief PCE is the actual chess engine
-	*
-	*/
-	class PCE {
+	 * @brief The result of a game
+	 */
+	enum class GameResult { ongoing, checkmate, stalemate, fifty_moves, repetition, insufficient_material };
+
+	/**
+	 * @brief A game without any console input or output (the rules and the result
+	 * of a game, for servers running many games at once)
+	 *
+	 */
+	class GameSession {
 		private:
 			/**
-			* @brief The moves played
-			*
-			*/
-			std::vector<Move> moves;
+			 * @brief The board
+			 */
+			board::Board board;
 			/**
-			 * @brief The boards played (by each move)
-			 * 
+			 * @brief The moves played
+			 */
+			std::vector<board::PackedMove> history;
+			/**
+			 * @brief The information needed to undo the moves played
+			 */
+			std::vector<board::UndoInfo> undos;
+
+			/**
+			 * @brief Checks if a square holds a piece of the side to move
+			 *
+			 * @param sq The square
+			 * @return If the piece can be moved this turn (bool)
+			 */
+			bool is_own_piece(int sq) {
+				return (this->board.get_pieces(this->board.is_white_turn()) & board::bitboards::bit(sq)) != 0;
+			}
+
+		public:
+			/**
+			 * @brief Construct a new GameSession object
+			 *
+			 * @param fen The starting position
+			 * @throw std::invalid_argument If the fen is not valid
+			 */
+			GameSession(std::string_view fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") : board(fen) {}
+
+			/**
+			 * @brief Gets whose turn it is
+			 *
+			 * @return If it is white's turn (bool)
+			 */
+			bool is_white_turn() const {
+				return this->board.is_white_turn();
+			}
+
+			/**
+			 * @brief Gets the legal moves of the side to move
+			 *
+			 * @return The moves (board::MoveList)
+			 */
+			board::MoveList legal_moves() {
+				return this->board.generate_moves(this->board.is_white_turn());
+			}
+
+			/**
+			 * @brief Finds the legal move written in long algebraic notation (e.g. e2e4,
+			 * e7e8q, e1g1 for castling)
+			 *
+			 * @param notation The move
+			 * @param move The legal move (output)
+			 * @return If the move is legal (bool)
+			 */
+			bool find_move(std::string_view notation, board::PackedMove &move) {
+				if (notation.size() != 4 && notation.size() != 5)
+					return false;
+				for (int i = 0; i < 4; i += 2) {
+					if (notation[i] < 'a' || notation[i] > 'h' || notation[i + 1] < '1' || notation[i + 1] > '8')
+						return false;
+				}
+				int from = board::bitboards::square(notation[1] - '1', notation[0] - 'a');
+				int to = board::bitboards::square(notation[3] - '1', notation[2] - 'a');
+				int promotion = -1;
+				if (notation.size() == 5) {
+					size_t type = std::string_view("prnbqk").find(notation[4]);
+					if (type == std::string_view::npos)
+						return false;
+					promotion = int(type);
+				}
+				if (!this->is_own_piece(from))
+					return false;
+				for (auto legal : this->board.generate_piece_moves(from)) {
+					if (legal.to() == to && legal.promotion() == promotion) {
+						move = legal;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			/**
+			 * @brief Plays a move if it is legal
+			 *
+			 * @param move The move
+			 * @return If the move was played (bool)
+			 */
+			bool apply_move(board::PackedMove move) {
+				if (!this->is_own_piece(move.from()))
+					return false;
+				bool legal = false;
+				for (auto candidate : this->board.generate_piece_moves(move.from()))
+					legal = legal || candidate == move;
+				if (!legal)
+					return false;
+				this->undos.push_back(this->board.make_move(move));
+				this->history.push_back(move);
+				return true;
+			}
+
+			/**
+			 * @brief Plays a move written in long algebraic notation if it is legal
+			 *
+			 * @param notation The move (e.g. e2e4, e7e8q, e1g1 for castling)
+			 * @return If the move was played (bool)
+			 */
+			bool apply_move(std::string_view notation) {
+				board::PackedMove move;
+				if (!this->find_move(notation, move))
+					return false;
+				this->undos.push_back(this->board.make_move(move));
+				this->history.push_back(move);
+				return true;
+			}
+
+			/**
+			 * @brief Takes back the last move played
+			 *
+			 * @return If there was a move to take back (bool)
+			 */
+			bool undo_move() {
+				if (this->history.empty())
+					return false;
+				this->board.unmake_move(this->undos.back());
+				this->undos.pop_back();
+				this->history.pop_back();
+				return true;
+			}
+
+			/**
+			 * @brief Gets the result of the game (a checkmate is lost by the side to
+			 * move)
+			 *
+			 * @return The result (GameResult)
+			 */
+			GameResult result() {
+				bool white = this->board.is_white_turn();
+				if (this->board.generate_moves(white).empty())
+					return this->board.is_check(white) ? GameResult::checkmate : GameResult::stalemate;
+				if (this->board.get_halfmove_clock() >= 100)
+					return GameResult::fifty_moves;
+				if (this->board.is_threefold_repetition())
+					return GameResult::repetition;
+				if (this->board.insufficient_material())
+					return GameResult::insufficient_material;
+				return GameResult::ongoing;
+			}
+
+			/**
+			 * @brief Gets the moves played
+			 *
+			 * @return The moves (const std::vector<board::PackedMove>&)
+			 */
+			const std::vector<board::PackedMove> &get_history() const {
+				return this->history;
+			}
+
+			/**
+			 * @brief Gets the board
+			 *
+			 * @return The board (const board::Board&)
+			 */
+			const board::Board &get_board() const {
+				return this->board;
+			}
+
+			/**
+			 * @brief Gets the fen string of the position
+			 *
+			 * @return The fen (std::string)
 			 */
-			std::vector<board::Board> boards;
+			std::string fen() const {
+				return this->board.to_fen();
+			}
+	};
+
+	/**
+	* @brief PCE is the actual chess engine (console game on top of a GameSession)
+	*
+	*/
+	class PCE {
+		private:
 			/**
-			* @brief The board
+			* @brief The game
 			*
 			*/
-			PlayeChessEngine::board::Board board = PlayeChessEngine::board::Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR");
+			GameSession session = GameSession("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR");
 			// Base fen 					: rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR
 			// Checkmate fen 				: 7k/Q7/6K1/8/8/8/8/8
 			// Stalemate fen 				: 7k/8/8/8/8/8/8/R5RK
@@ -1292,112 +3774,54 @@ namespace PlayeChessEngine {
 			// Repetition fen 				: r6k/8/8/8/8/8/8/R6K
 
 			/**
-			 * @brief The move countdown
-			 * 
-			 */
-			int move_countdown = 50;
-
-			/**
-			 * @brief Clears the screen
+			 * @brief Clears the screen (with escape codes, without starting a shell)
 			 * 
 			 */
 			void clear_screen() {
-				#ifdef _WIN32
-					std::system("cls");
-				#else
-					std::system("clear");
-				#endif
-			}
-
-			/**
-			 * @brief Converts a vector of coordinates to an array of coordinates
-			 * 
-			 * @param coords The vector of coordinates
-			 * @return The array of coordinates (std::array<int, 2>)
-			 */
-			std::array<int, 2> coords_to_array(std::vector<int> coords) {
-				std::array<int, 2> array;
-				array[0] = coords[0];
-				array[1] = coords[1];
-				return array;
+				std::cout << "\033[2J\033[H";
 			}
 
 			/**
 			* @brief Plays a move
 			*
-			* @param white If the color is white
-			* @return If the move was played (bool)
+			* @return If the game was exited (bool)
 			*/
-			bool move(bool white) {
+			bool move() {
 				this->clear_screen();
-				this->board.set_moves(this->moves);
-				this->board.set_white_turn(white);
+				bool white = this->session.is_white_turn();
 				std::string move;
 				if (white)
 					std::cout << "> White to play <" << std::endl;
 				else
 					std::cout << "> Black to play <" << std::endl;
-				std::vector<Move> color_moves = this->board.get_all_moves(this->board.get_board(), white);
-				for (auto move : color_moves) {
-					std::cout << move.show() << std::endl;
+				for (auto legal : this->session.legal_moves()) {
+					std::cout << legal.to_move().show() << std::endl;
 				}
-				this->board.print_board(this->board.get_all_landing_moves(this->board.get_board(), white));
-				bool valid = false;
-				while (!valid) {
+				board::Board shown = this->session.get_board();
+				shown.print_board(shown.get_all_landing_moves(shown.get_board(), white));
+				while (true) {
 					do {
 						std::cout << "> ";
 						std::cin >> move;
+						if (!std::cin)
+							return true;
 					} while (move.length() != 4 && move != "exit" && move != "O-O" && move != "O-O-O");
 					if (move == "exit")
 						return true;
-					if (move == "O-O") {
-						if (this->board.can_castle(white, true)) {
-							this->board.castle(white, true);
-							return false;
-						}
-					}
-					if (move == "O-O-O") {
-						if (this->board.can_castle(white, false)) {
-							this->board.castle(white, false);
-							return false;
-						}
-					}
-                    /*for(auto move : this->board.get_moves(move[1] - '1', move[0] - 'a')) {
-                        std::cout << move.show() << std::endl;
-                    }*/
-					Move move_obj = Move(move[1] - '1', move[0] - 'a', move[3] - '1', move[2] - 'a');
-					board::pieces::piece_type type = this->board.get_board()[move_obj.get_start_coords()[0]][move_obj.get_start_coords()[1]]->get_type();
-					move_obj = this->board.move(this->moves, move_obj, white);
-
-					valid = move_obj.get_valid();
-
-					if (valid) {
-						this->moves.push_back(move_obj);
-						this->boards.push_back(this->board);
-					}
-					
-					if(!move_obj.get_capture() || type == board::pieces::piece_type::p)
-						this->move_countdown = 50;
-					else
-						this->move_countdown--;
-
-					if(type == board::pieces::piece_type::p) {
-						if(this->board.get_promotion(white) != std::array{-1, -1}) {
-							std::string promotion;
-							std::cout << "Promote to (Q, R, B, N): ";
-							std::cin >> promotion;
-							board::pieces::piece_type promotion_type = board::pieces::piece_type::q;
-							if(promotion == "R")
-								promotion_type = board::pieces::piece_type::r;
-							else if(promotion == "B")
-								promotion_type = board::pieces::piece_type::b;
-							else if(promotion == "N")
-								promotion_type = board::pieces::piece_type::n;
-							this->board.promote(white, this->board.get_promotion(white), promotion_type);
-						}
+					if (move == "O-O")
+						move = white ? "e1g1" : "e8g8";
+					if (move == "O-O-O")
+						move = white ? "e1c1" : "e8c8";
+					board::PackedMove promotion;
+					if (this->session.find_move(move + "q", promotion)) {
+						std::string piece;
+						std::cout << "Promote to (Q, R, B, N): ";
+						std::cin >> piece;
+						move += piece == "R" ? "r" : piece == "B" ? "b" : piece == "N" ? "n" : "q";
 					}
+					if (this->session.apply_move(move))
+						return false;
 				}
-				return false;
 			}
 
 		public:
@@ -1412,49 +3836,32 @@ namespace PlayeChessEngine {
 			*
 			*/
 			void main() {
-				int move_count = 0;
-				bool break_loop = false;
-				this->boards.push_back(this->board);
-				while (true) {
-					bool white = move_count % 2 == 0;
-					break_loop = this->move(white);
-					if (break_loop)
-						break;
-					if (this->board.status(!white) == 1) {
-						this->clear_screen();
-						this->board.print_board();
-						if (white)
-							std::cout << "White wins (checkmate)" << std::endl;
-						else
-							std::cout << "Black wins (checkmate)" << std::endl;
-						break;
-					} else if (this->board.status(!white) == 2) {
-						this->clear_screen();
-						this->board.print_board();
+				while (!this->move()) {
+					GameResult result = this->session.result();
+					if (result == GameResult::ongoing)
+						continue;
+					this->clear_screen();
+					board::Board shown = this->session.get_board();
+					shown.print_board();
+					if (result == GameResult::checkmate && this->session.is_white_turn())
+						std::cout << "Black wins (checkmate)" << std::endl;
+					else if (result == GameResult::checkmate)
+						std::cout << "White wins (checkmate)" << std::endl;
+					else if (result == GameResult::stalemate)
 						std::cout << "Draw (stalemate)" << std::endl;
-						break;
-					} else if(this->board.insufficient_material()) {
-						this->clear_screen();
-						this->board.print_board();
+					else if (result == GameResult::insufficient_material)
 						std::cout << "Draw (insufficient material)" << std::endl;
-						break;
-					} else if(this->move_countdown == 0) {
-						this->clear_screen();
-						this->board.print_board();
+					else if (result == GameResult::fifty_moves)
 						std::cout << "Draw (50 move rule)" << std::endl;
-						break;
-					} else if(this->board.check_threefold_repetition(this->boards, white)) {
-						this->clear_screen();
-						this->board.print_board();
+					else
 						std::cout << "Draw (threefold repetition)" << std::endl;
-						break;
-					}
-					move_count++;
+					break;
 				}
-				for (int i = 0; i < this->moves.size(); i += 2) {
-					std::cout << i / 2 + 1 << ".. " << this->moves[i].show();
-					if (i + 1 < this->moves.size())
-						std::cout << " " << this->moves[i + 1].show() << std::endl;
+				const std::vector<board::PackedMove> &moves = this->session.get_history();
+				for (size_t i = 0; i < moves.size(); i += 2) {
+					std::cout << i / 2 + 1 << ".. " << moves[i].to_move().show();
+					if (i + 1 < moves.size())
+						std::cout << " " << moves[i + 1].to_move().show() << std::endl;
 					else
 						std::cout << std::endl;
 				}
@@ -0,0 +1,483 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The time the program started (initialized before anything of pce.cpp,
+ * used by --startup)
+ */
+const std::chrono::steady_clock::time_point program_start = std::chrono::steady_clock::now();
+
+#include "pce.cpp"
+
+/**
+ * @brief The number of heap allocations made by the program (counted by the
+ * replaced global operator new, used by --alloc-check)
+ */
+std::atomic<uint64_t> allocations{0};
+
+__attribute__((noinline)) void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+/**
+ * @brief A reference position with its known perft counts
+ */
+struct PerftPosition {
+    std::string name;
+    std::string fen;
+    std::vector<uint64_t> counts;
+};
+
+/**
+ * @brief The reference positions (https://www.chessprogramming.org/Perft_Results),
+ * counts are given from depth 1
+ */
+const std::vector<PerftPosition> suite = {
+    {"Initial position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {20, 400, 8902, 197281, 4865609}},
+    {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862, 4085603}},
+    {"Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624, 11030083}},
+    {"Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264, 9467, 422333, 15833292}},
+    {"Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379, 2103487}},
+    {"Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", {46, 2079, 89890, 3894594}},
+};
+
+/**
+ * @brief A hash table of perft counts shared by all the threads without locks
+ * (an entry is only trusted if its check word matches its data)
+ */
+class PerftTable {
+    private:
+        /**
+         * @brief An entry (check = key ^ data, data = nodes << 8 | depth)
+         */
+        struct Entry {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> data{0};
+        };
+
+        /**
+         * @brief The entries
+         */
+        std::unique_ptr<Entry[]> entries;
+
+        /**
+         * @brief The mask of the entry index (number of entries - 1)
+         */
+        uint64_t mask = 0;
+
+        /**
+         * @brief Gets the entry of a position and depth
+         *
+         * @param key The zobrist key of the position
+         * @param depth The depth
+         * @return The entry (Entry&)
+         */
+        Entry &entry(uint64_t key, int depth) {
+            return this->entries[(key ^ (uint64_t(depth) * 0x9E3779B97F4A7C15ULL)) & this->mask];
+        }
+
+    public:
+        /**
+         * @brief Construct a new PerftTable object
+         *
+         * @param megabytes The size of the table (rounded down to a power of two, 0
+         * disables the table)
+         */
+        PerftTable(size_t megabytes) {
+            size_t count = megabytes * 1024 * 1024 / sizeof(Entry);
+            if (count == 0)
+                return;
+            while (count & (count - 1))
+                count &= count - 1;
+            this->entries.reset(new Entry[count]);
+            this->mask = count - 1;
+        }
+
+        /**
+         * @brief Looks for the count of a position
+         *
+         * @param key The zobrist key of the position
+         * @param depth The depth
+         * @param nodes The count (output)
+         * @return If the count was found (bool)
+         */
+        bool probe(uint64_t key, int depth, uint64_t &nodes) {
+            if (!this->entries)
+                return false;
+            Entry &entry = this->entry(key, depth);
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            uint64_t check = entry.check.load(std::memory_order_relaxed);
+            if ((check ^ data) != key || int(data & 0xFF) != depth)
+                return false;
+            nodes = data >> 8;
+            return true;
+        }
+
+        /**
+         * @brief Stores the count of a position
+         *
+         * @param key The zobrist key of the position
+         * @param depth The depth
+         * @param nodes The count
+         */
+        void store(uint64_t key, int depth, uint64_t nodes) {
+            if (!this->entries)
+                return;
+            Entry &entry = this->entry(key, depth);
+            uint64_t data = nodes << 8 | uint64_t(depth);
+            entry.data.store(data, std::memory_order_relaxed);
+            entry.check.store(key ^ data, std::memory_order_relaxed);
+        }
+};
+
+/**
+ * @brief Counts the leaf nodes of the legal move tree using the hash table
+ *
+ * @param board The board
+ * @param depth The depth
+ * @param table The hash table
+ * @return The number of leaf nodes (uint64_t)
+ */
+uint64_t hashed_perft(PlayeChessEngine::board::Board &board, int depth, PerftTable &table) {
+    if (depth <= 0)
+        return 1;
+    if (depth == 1)
+        return board.perft(1);
+    uint64_t nodes = 0;
+    if (table.probe(board.get_key(), depth, nodes))
+        return nodes;
+    for (auto move : board.generate_moves(board.is_white_turn())) {
+        PlayeChessEngine::board::UndoInfo undo = board.make_move(move);
+        nodes += hashed_perft(board, depth - 1, table);
+        board.unmake_move(undo);
+    }
+    table.store(board.get_key(), depth, nodes);
+    return nodes;
+}
+
+/**
+ * @brief Counts the leaf nodes under every root move with a pool of threads (the
+ * work is split at the second ply so that positions with few root moves scale too)
+ *
+ * @param fen The position
+ * @param depth The depth
+ * @param threads The number of threads
+ * @param hash_mb The size of the shared hash table (in MB)
+ * @param moves The root moves (output)
+ * @return The count of each root move (std::vector<uint64_t>)
+ */
+std::vector<uint64_t> parallel_divide(std::string fen, int depth, int threads, size_t hash_mb, PlayeChessEngine::board::MoveList &moves) {
+    PlayeChessEngine::board::Board root = PlayeChessEngine::board::Board(fen);
+    PerftTable table = PerftTable(hash_mb);
+    moves = root.generate_moves(root.is_white_turn());
+    std::vector<std::pair<int, PlayeChessEngine::board::PackedMove>> work;
+    for (int i = 0; i < moves.size(); i++) {
+        if (depth < 3) {
+            work.push_back({i, moves[i]});
+            continue;
+        }
+        PlayeChessEngine::board::UndoInfo undo = root.make_move(moves[i]);
+        for (auto reply : root.generate_moves(root.is_white_turn()))
+            work.push_back({i, reply});
+        root.unmake_move(undo);
+    }
+    std::vector<std::atomic<uint64_t>> counts(moves.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        PlayeChessEngine::board::Board board = root;
+        for (size_t item = next++; item < work.size(); item = next++) {
+            int i = work[item].first;
+            if (depth < 3) {
+                PlayeChessEngine::board::UndoInfo undo = board.make_move(moves[i]);
+                counts[i] += hashed_perft(board, depth - 1, table);
+                board.unmake_move(undo);
+                continue;
+            }
+            PlayeChessEngine::board::UndoInfo undo = board.make_move(moves[i]);
+            PlayeChessEngine::board::UndoInfo reply_undo = board.make_move(work[item].second);
+            counts[i] += hashed_perft(board, depth - 2, table);
+            board.unmake_move(reply_undo);
+            board.unmake_move(undo);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &thread : pool)
+        thread.join();
+    std::vector<uint64_t> result;
+    for (auto &count : counts)
+        result.push_back(count.load());
+    return result;
+}
+
+/**
+ * @brief Gets the seconds elapsed since a time point
+ *
+ * @param start The time point
+ * @return The seconds elapsed (double)
+ */
+double elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Counts the leaf nodes of a position with a pool of threads
+ *
+ * @param fen The position
+ * @param depth The depth
+ * @param threads The number of threads
+ * @param hash_mb The size of the shared hash table (in MB)
+ * @return The number of leaf nodes (uint64_t)
+ */
+uint64_t parallel_perft(std::string fen, int depth, int threads, size_t hash_mb) {
+    if (depth <= 0)
+        return 1;
+    PlayeChessEngine::board::MoveList moves;
+    uint64_t total = 0;
+    for (auto nodes : parallel_divide(fen, depth, threads, hash_mb, moves))
+        total += nodes;
+    return total;
+}
+
+/**
+ * @brief Prints the node count of every root move, then the total, time and speed
+ * (and the scaling against one thread when several threads are used)
+ *
+ * @param fen The position
+ * @param depth The depth
+ * @param threads The number of threads
+ * @param hash_mb The size of the shared hash table (in MB)
+ * @return The total number of nodes (uint64_t)
+ */
+uint64_t divide(std::string fen, int depth, int threads, size_t hash_mb) {
+    PlayeChessEngine::board::MoveList moves;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> counts = parallel_divide(fen, depth, threads, hash_mb, moves);
+    double seconds = elapsed(start);
+    uint64_t total = 0;
+    for (int i = 0; i < moves.size(); i++) {
+        std::cout << moves[i].notation() << ": " << counts[i] << std::endl;
+        total += counts[i];
+    }
+    std::cout << std::endl << "Nodes: " << total << std::endl;
+    std::cout << "Time: " << seconds << " s" << std::endl;
+    std::cout << "NPS: " << uint64_t(total / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+    if (threads > 1) {
+        auto single_start = std::chrono::steady_clock::now();
+        parallel_perft(fen, depth, 1, hash_mb);
+        double single_seconds = elapsed(single_start);
+        double speedup = single_seconds / (seconds > 0 ? seconds : 1e-9);
+        std::cout << "1 thread: " << single_seconds << " s, " << threads << " threads: " << seconds << " s" << std::endl;
+        std::cout << "Speedup: " << speedup << "x, efficiency: " << 100 * speedup / threads << " %" << std::endl;
+    }
+    return total;
+}
+
+/**
+ * @brief Runs the reference suite and checks the counts
+ *
+ * @param max_depth The maximum depth to run (clamped to the known counts of each position)
+ * @param threads The number of threads
+ * @param hash_mb The size of the shared hash table (in MB)
+ * @return If every count matched (bool)
+ */
+bool run_suite(int max_depth, int threads, size_t hash_mb) {
+    bool ok = true;
+    uint64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto position : suite) {
+        int depth = std::clamp(max_depth, 1, int(position.counts.size()));
+        auto position_start = std::chrono::steady_clock::now();
+        uint64_t nodes = parallel_perft(position.fen, depth, threads, hash_mb);
+        double seconds = elapsed(position_start);
+        bool match = nodes == position.counts[depth - 1];
+        ok = ok && match;
+        total += nodes;
+        std::cout << (match ? "[OK]   " : "[FAIL] ") << position.name << " depth " << depth << ": " << nodes;
+        if (!match)
+            std::cout << " (expected " << position.counts[depth - 1] << ")";
+        std::cout << " in " << seconds << " s" << std::endl;
+    }
+    double seconds = elapsed(start);
+    std::cout << std::endl << "Nodes: " << total << std::endl;
+    std::cout << "Time: " << seconds << " s" << std::endl;
+    std::cout << "NPS: " << uint64_t(total / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+    return ok;
+}
+
+/**
+ * @brief Validates and plays every legal move of the reference positions (and
+ * checks every square with the piece validation functions), then checks that no
+ * heap allocation was made (the game history is warmed up by a first pass)
+ *
+ * @return If no allocation was made (bool)
+ */
+bool alloc_check() {
+    bool ok = true;
+    for (auto position : suite) {
+        PlayeChessEngine::board::Board board = PlayeChessEngine::board::Board(position.fen);
+        const std::vector<PlayeChessEngine::Move> history;
+        bool white = board.is_white_turn();
+        std::array<std::array<PlayeChessEngine::board::pieces::Piece *, 8>, 8> view = board.get_board();
+        uint64_t validated = 0;
+        uint64_t before = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            before = allocations.load();
+            validated = 0;
+            for (auto packed : board.generate_moves(white)) {
+                PlayeChessEngine::Move move = packed.to_move();
+                if (board.premove_check(move, white) || !board.move(history, move, white).get_valid())
+                    ok = false;
+                board.takeback();
+                validated++;
+            }
+            for (int from = 0; from < 64; from++) {
+                PlayeChessEngine::board::pieces::Piece *piece = view[from / 8][from % 8];
+                if (piece == nullptr)
+                    continue;
+                for (int to = 0; to < 64; to++) {
+                    piece->validation_function(view, to / 8, to % 8);
+                    validated++;
+                }
+            }
+            board.is_check(white);
+            board.perft(2);
+        }
+        uint64_t made = allocations.load() - before;
+        ok = ok && made == 0;
+        std::cout << (made == 0 ? "[OK]   " : "[FAIL] ") << position.name << ": " << validated << " validations, " << made << " allocations" << std::endl;
+    }
+    return ok;
+}
+
+/**
+ * @brief Checks that a game session only plays the moves of the side to move
+ * (in notation and packed) and that a rejected move leaves the position as it
+ * was
+ *
+ * @return If every check passed (bool)
+ */
+bool session_check() {
+    struct Case {
+        std::string fen;
+        std::string move;
+        bool legal;
+    };
+    const std::vector<Case> cases = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "e7e5", false},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "g8f6", false},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "e2e4", true},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1", "d2d4", false},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1", "e7e5", true},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "e3e4", false},
+    };
+    bool ok = true;
+    for (const Case &test : cases) {
+        int from = PlayeChessEngine::board::bitboards::square(test.move[1] - '1', test.move[0] - 'a');
+        int to = PlayeChessEngine::board::bitboards::square(test.move[3] - '1', test.move[2] - 'a');
+        PlayeChessEngine::GameSession by_notation(test.fen), by_packed(test.fen);
+        bool played = by_notation.apply_move(test.move);
+        bool played_packed = by_packed.apply_move(PlayeChessEngine::board::PackedMove(from, to));
+        bool unchanged = test.legal || (by_notation.fen() == test.fen && by_packed.fen() == test.fen);
+        bool passed = played == test.legal && played_packed == test.legal && unchanged;
+        ok = ok && passed;
+        std::cout << (passed ? "[OK]   " : "[FAIL] ") << test.move << " in " << test.fen << (test.legal ? " is played" : " is rejected") << std::endl;
+    }
+    return ok;
+}
+
+/**
+ * @brief Measures the time from the start of the program to the first validated
+ * move, and the time taken by the only tables filled at startup (the sliders)
+ *
+ * @return If the move was validated (bool)
+ */
+bool startup_check() {
+    PlayeChessEngine::board::Board board = PlayeChessEngine::board::Board(suite[0].fen);
+    PlayeChessEngine::Move move = board.move({}, PlayeChessEngine::Move(1, 4, 3, 4), true);
+    double first = elapsed(program_start) * 1e6;
+    auto start = std::chrono::steady_clock::now();
+    PlayeChessEngine::board::bitboards::sliders.build(PlayeChessEngine::board::bitboards::sliders.use_pext);
+    double fill = elapsed(start) * 1e6;
+    std::cout << "Start to first validated move: " << first << " us" << std::endl;
+    std::cout << "Slider tables fill (" << (PlayeChessEngine::board::bitboards::sliders.use_pext ? "PEXT" : "magics") << "): " << fill << " us" << std::endl;
+    return move.get_valid();
+}
+
+/**
+ * @brief Usage:
+ *   perft <depth> [fen]      divide of a position (initial position by default)
+ *   perft --suite [depth]    reference suite (deepest known count by default)
+ *   perft --alloc-check      checks that move validation makes no heap allocation
+ *   perft --session-check    checks that a game session only plays the moves of the side to move
+ *   perft --startup          time from the start of the program to the first validated move
+ * Options:
+ *   --threads <n>            number of threads (default 1)
+ *   --hash <mb>              size of the shared hash table (default 0, disabled)
+ */
+int main(int argc, char *argv[]) {
+    std::vector<std::string> args;
+    int threads = 1;
+    size_t hash_mb = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--hash" && i + 1 < argc)
+            hash_mb = std::stoul(argv[++i]);
+        else
+            args.push_back(arg);
+    }
+    const std::string usage = "Usage: perft <depth> [fen] | perft --suite [depth] | perft --alloc-check | perft --session-check | perft --startup [--threads n] [--hash mb]";
+    if (args.empty()) {
+        std::cout << usage << std::endl;
+        return 1;
+    }
+    if (args[0] == "--startup")
+        return startup_check() ? 0 : 1;
+    if (args[0] == "--alloc-check")
+        return alloc_check() ? 0 : 1;
+    if (args[0] == "--session-check")
+        return session_check() ? 0 : 1;
+    int depth = args[0] == "--suite" ? (args.size() > 1 ? std::stoi(args[1]) : 99) : std::stoi(args[0]);
+    if (depth < 1) {
+        std::cout << "The depth must be at least 1" << std::endl << usage << std::endl;
+        return 1;
+    }
+    if (args[0] == "--suite")
+        return run_suite(depth, threads, hash_mb) ? 0 : 1;
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    if (args.size() > 1) {
+        fen = args[1];
+        for (size_t i = 2; i < args.size(); i++)
+            fen += " " + args[i];
+    }
+    try {
+        divide(fen, depth, threads, hash_mb);
+    } catch (const std::invalid_argument &error) {
+        std::cout << error.what() << std::endl << usage << std::endl;
+        return 1;
+    }
+    return 0;
+}
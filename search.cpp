@@ -0,0 +1,1011 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "nnue.cpp"
+
+namespace PlayeChessEngine {
+	namespace search {
+		/**
+		 * @brief A score no position reaches
+		 */
+		constexpr int infinity = 32000;
+		/**
+		 * @brief The score of a checkmate (a mate in n plies scores mate - n)
+		 */
+		constexpr int mate = 31000;
+		/**
+		 * @brief Scores above this are mates
+		 */
+		constexpr int mate_bound = mate - 1000;
+		/**
+		 * @brief The maximum number of plies from the root
+		 */
+		constexpr int max_ply = 128;
+
+		/**
+		 * @brief The value of each piece type (p, r, n, b, q, k) in centipawns (to
+		 * order the captures)
+		 */
+		constexpr std::array<int, 6> piece_values = {100, 500, 320, 330, 900, 0};
+
+		/**
+		 * @brief The order in which the pieces of each type (p, r, n, b, q, k) should
+		 * capture (least valuable attacker first)
+		 */
+		constexpr std::array<int, 6> attacker_order = {0, 3, 1, 2, 4, 5};
+
+		/**
+		 * @brief Evaluates a position (refer to board::Board::evaluate)
+		 *
+		 * @param board The position
+		 * @return The score for the side to move (in centipawns) (int)
+		 */
+		int evaluate(const board::Board &board) {
+			return board.evaluate();
+		}
+
+		/**
+		 * @brief The kind of score stored in the transposition table
+		 */
+		enum bound_type { no_bound, upper_bound, lower_bound, exact_bound };
+
+		/**
+		 * @brief A transposition table entry once read
+		 */
+		struct TTData {
+			/**
+			 * @brief The best move found (raw 0 if none)
+			 */
+			board::PackedMove move{};
+			/**
+			 * @brief The score (mates are relative to the position, refer to
+			 * TranspositionTable::probe)
+			 */
+			int score = 0;
+			/**
+			 * @brief The depth of the search that found the score
+			 */
+			int depth = 0;
+			/**
+			 * @brief The kind of score (refer to the bound_type enum)
+			 */
+			bound_type bound = no_bound;
+		};
+
+		/**
+		 * @brief A transposition table shared by all the search threads without locks:
+		 * an entry is two words (key ^ data, data) and is only trusted if they match
+		 * the key, so a torn write is read as a miss. Entries are grouped by four in
+		 * buckets of one cache line.
+		 *
+		 */
+		class TranspositionTable {
+			private:
+				/**
+				 * @brief An entry (data = move | score << 16 | depth << 32 | bound << 40 | age
+				 * << 42)
+				 */
+				struct Entry {
+					std::atomic<uint64_t> check{0};
+					std::atomic<uint64_t> data{0};
+				};
+
+				/**
+				 * @brief The entries of a cache line
+				 */
+				struct alignas(64) Bucket {
+					std::array<Entry, 4> entries;
+				};
+
+				/**
+				 * @brief The buckets
+				 */
+				Bucket *buckets = nullptr;
+				/**
+				 * @brief The number of buckets
+				 */
+				uint64_t count = 0;
+				/**
+				 * @brief The age of the current search (6 bits, refer to new_search)
+				 */
+				uint8_t age = 0;
+
+				/**
+				 * @brief Gets the bucket of a position (the key is mapped on any number of
+				 * buckets with a multiplication)
+				 *
+				 * @param key The zobrist key of the position
+				 * @return The bucket (Bucket&)
+				 */
+				Bucket &bucket(uint64_t key) const {
+					return this->buckets[uint64_t((unsigned __int128)key * this->count >> 64)];
+				}
+
+				/**
+				 * @brief Frees the buckets
+				 */
+				void release() {
+					if (!this->buckets)
+						return;
+					for (uint64_t i = 0; i < this->count; i++)
+						this->buckets[i].~Bucket();
+					std::free(this->buckets);
+					this->buckets = nullptr;
+					this->count = 0;
+				}
+
+			public:
+				/**
+				 * @brief Construct a new TranspositionTable object
+				 *
+				 * @param megabytes The size of the table
+				 */
+				TranspositionTable(size_t megabytes = 16) {
+					this->resize(megabytes);
+				}
+
+				TranspositionTable(const TranspositionTable &) = delete;
+				TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+				~TranspositionTable() {
+					this->release();
+				}
+
+				/**
+				 * @brief Reallocates the table (the entries are lost, no search may be
+				 * running). Tables of 2 MB and more are aligned on 2 MB and backed by huge
+				 * pages where the system allows it.
+				 *
+				 * @param megabytes The size of the table (at least 1)
+				 */
+				void resize(size_t megabytes) {
+					this->release();
+					size_t bytes = std::max<size_t>(1, megabytes) * 1024 * 1024;
+					size_t alignment = bytes >= (2u << 20) ? (2u << 20) : alignof(Bucket);
+					void *memory = std::aligned_alloc(alignment, bytes);
+					if (!memory)
+						throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+					if (alignment == (2u << 20))
+						madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+					this->count = bytes / sizeof(Bucket);
+					this->buckets = new (memory) Bucket[this->count];
+				}
+
+				/**
+				 * @brief Empties the table (no search may be running)
+				 */
+				void clear() {
+					for (uint64_t i = 0; i < this->count; i++) {
+						for (Entry &entry : this->buckets[i].entries) {
+							entry.check.store(0, std::memory_order_relaxed);
+							entry.data.store(0, std::memory_order_relaxed);
+						}
+					}
+					this->age = 0;
+				}
+
+				/**
+				 * @brief Starts a new search (the entries of older searches are replaced
+				 * first)
+				 */
+				void new_search() {
+					this->age = (this->age + 1) & 63;
+				}
+
+				/**
+				 * @brief Gets the size of the table
+				 *
+				 * @return The size in bytes (size_t)
+				 */
+				size_t size() const {
+					return this->count * sizeof(Bucket);
+				}
+
+				/**
+				 * @brief Looks for a position
+				 *
+				 * @param key The zobrist key of the position
+				 * @param ply The distance of the position to the root (mate scores are stored
+				 * relative to the position and returned relative to the root)
+				 * @param found The entry (output)
+				 * @return If the position was found (bool)
+				 */
+				bool probe(uint64_t key, int ply, TTData &found) const {
+					for (const Entry &entry : this->bucket(key).entries) {
+						uint64_t data = entry.data.load(std::memory_order_relaxed);
+						if (data == 0 || (entry.check.load(std::memory_order_relaxed) ^ data) != key)
+							continue;
+						found.move = board::PackedMove::from_raw(uint16_t(data));
+						found.score = int16_t(uint16_t(data >> 16));
+						found.depth = int(uint8_t(data >> 32));
+						found.bound = bound_type((data >> 40) & 3);
+						if (found.score > mate_bound)
+							found.score -= ply;
+						else if (found.score < -mate_bound)
+							found.score += ply;
+						return true;
+					}
+					return false;
+				}
+
+				/**
+				 * @brief Stores a position, replacing its entry or the entry of the bucket
+				 * with the lowest depth (the entries of older searches count as shallower)
+				 *
+				 * @param key The zobrist key of the position
+				 * @param ply The distance of the position to the root
+				 * @param move The best move (raw 0 if none, the stored move is then kept)
+				 * @param score The score
+				 * @param depth The depth of the search
+				 * @param bound The kind of score
+				 */
+				void store(uint64_t key, int ply, board::PackedMove move, int score, int depth, bound_type bound) {
+					Bucket &bucket = this->bucket(key);
+					Entry *replaced = nullptr;
+					int lowest = 1 << 30;
+					for (Entry &entry : bucket.entries) {
+						uint64_t data = entry.data.load(std::memory_order_relaxed);
+						if (data != 0 && (entry.check.load(std::memory_order_relaxed) ^ data) == key) {
+							if (move.raw() == 0)
+								move = board::PackedMove::from_raw(uint16_t(data));
+							// A deeper result of this search is kept, unless the new one is exact
+							if (int(uint8_t(data >> 32)) > depth + 2 && int((data >> 42) & 63) == this->age && bound != exact_bound)
+								return;
+							replaced = &entry;
+							break;
+						}
+						int relative_age = (this->age - int((data >> 42) & 63)) & 63;
+						int value = data == 0 ? -(1 << 20) : int(uint8_t(data >> 32)) - 8 * relative_age;
+						if (value < lowest) {
+							lowest = value;
+							replaced = &entry;
+						}
+					}
+					if (score > mate_bound)
+						score += ply;
+					else if (score < -mate_bound)
+						score -= ply;
+					uint64_t data = uint64_t(move.raw()) | uint64_t(uint16_t(int16_t(score))) << 16 | uint64_t(uint8_t(std::clamp(depth, 0, 255))) << 32 | uint64_t(bound) << 40 | uint64_t(this->age) << 42;
+					replaced->check.store(key ^ data, std::memory_order_relaxed);
+					replaced->data.store(data, std::memory_order_relaxed);
+				}
+
+				/**
+				 * @brief Gets how full the table is (sampled on the first thousand entries)
+				 *
+				 * @return The entries of the current search per thousand (int)
+				 */
+				int hashfull() const {
+					int used = 0, sampled = 0;
+					for (uint64_t i = 0; i < this->count && sampled < 1000; i++) {
+						for (const Entry &entry : this->buckets[i].entries) {
+							uint64_t data = entry.data.load(std::memory_order_relaxed);
+							used += data != 0 && int((data >> 42) & 63) == this->age;
+							sampled++;
+						}
+					}
+					return sampled ? used * 1000 / sampled : 0;
+				}
+		};
+
+		/**
+		 * @brief The limits of a search (0 means no limit)
+		 */
+		struct Limits {
+			/**
+			 * @brief The maximum depth (in plies)
+			 */
+			int depth = 0;
+			/**
+			 * @brief The maximum number of nodes
+			 */
+			uint64_t nodes = 0;
+			/**
+			 * @brief The maximum time (in milliseconds)
+			 */
+			int64_t time = 0;
+			/**
+			 * @brief Stops the search when set by another thread (optional)
+			 */
+			const std::atomic<bool> *stop = nullptr;
+		};
+
+		/**
+		 * @brief The result of a search (updated after every completed depth)
+		 */
+		struct Result {
+			/**
+			 * @brief The best move (the first legal move if no depth was completed, a
+			 * null move (raw 0) if there is none)
+			 */
+			board::PackedMove best{};
+			/**
+			 * @brief The score of the best move for the side to move (in centipawns,
+			 * refer to mate for mates)
+			 */
+			int score = 0;
+			/**
+			 * @brief The last completed depth
+			 */
+			int depth = 0;
+			/**
+			 * @brief The number of nodes searched
+			 */
+			uint64_t nodes = 0;
+			/**
+			 * @brief The time spent (in milliseconds)
+			 */
+			int64_t time = 0;
+			/**
+			 * @brief The number of transposition table lookups
+			 */
+			uint64_t tt_probes = 0;
+			/**
+			 * @brief The number of lookups that found the position
+			 */
+			uint64_t tt_hits = 0;
+			/**
+			 * @brief The number of beta cutoffs (full-width nodes only)
+			 */
+			uint64_t cutoffs = 0;
+			/**
+			 * @brief The number of cutoffs made by the first move tried (a measure of the
+			 * move ordering)
+			 */
+			uint64_t first_move_cutoffs = 0;
+			/**
+			 * @brief The principal variation (the best move first)
+			 */
+			std::vector<board::PackedMove> pv;
+
+			/**
+			 * @brief Gets the score in UCI notation
+			 *
+			 * @return "cp <centipawns>" or "mate <moves>" (negative if the side to move
+			 * is mated) (std::string)
+			 */
+			std::string uci_score() const {
+				if (this->score > mate_bound)
+					return "mate " + std::to_string((mate - this->score + 1) / 2);
+				if (this->score < -mate_bound)
+					return "mate -" + std::to_string((mate + this->score) / 2);
+				return "cp " + std::to_string(this->score);
+			}
+		};
+
+		/**
+		 * @brief Checks if a move takes a piece or promotes
+		 *
+		 * @param board The position before the move
+		 * @param move The move
+		 * @return If the move is tactical (bool)
+		 */
+		bool is_tactical(const board::Board &board, board::PackedMove move) {
+			return board.get_piece_code(move.to()) >= 0 || move.flag() == board::PackedMove::en_passant_move || move.flag() == board::PackedMove::promotion_move;
+		}
+
+		/**
+		 * @brief The butterfly history: the cutoffs of the quiet moves by side, start
+		 * square and end square
+		 */
+		using History = std::array<std::array<std::array<int, 64>, 64>, 2>;
+
+		/**
+		 * @brief Gives the moves of a position one at a time, generating them in stages
+		 * so that a cutoff skips most of the generation: the first move (previous
+		 * principal variation or hash move) without generating, then the captures and
+		 * promotions by MVV-LVA (most valuable victim, then least valuable attacker),
+		 * then the killer moves, then the quiet moves by history
+		 */
+		class MovePicker {
+			private:
+				/**
+				 * @brief The stages, in order
+				 */
+				enum picker_stage { first_stage, tactical_init, tactical_stage, killer_stage, quiet_init, quiet_stage, done_stage };
+
+				board::Board &board;
+				const History &history;
+				/**
+				 * @brief The move to try first and the killer moves (raw 0 if none)
+				 */
+				board::PackedMove first;
+				std::array<board::PackedMove, 2> killers;
+				/**
+				 * @brief If only the captures and promotions are given (quiescence search)
+				 */
+				bool tactical_only;
+				int stage = first_stage;
+				/**
+				 * @brief The moves of the current stage and their scores
+				 */
+				board::MoveList moves;
+				std::array<int, 256> scores;
+				int index = 0;
+				int killer_index = 0;
+				/**
+				 * @brief The number of moves given
+				 */
+				int given = 0;
+
+				/**
+				 * @brief Scores a capture or promotion by MVV-LVA
+				 *
+				 * @param move The move
+				 * @return The score (int)
+				 */
+				int score_tactical(board::PackedMove move) const {
+					int victim = this->board.get_piece_code(move.to());
+					int value = victim >= 0 ? piece_values[victim % 6] : move.flag() == board::PackedMove::en_passant_move ? piece_values[0] : 0;
+					if (move.flag() == board::PackedMove::promotion_move)
+						value += piece_values[move.promotion()] - piece_values[0];
+					return value * 8 - attacker_order[this->board.get_piece_code(move.from()) % 6];
+				}
+
+				/**
+				 * @brief Takes the best scored of the remaining moves of the stage (selection
+				 * sort, so moves after a cutoff are never sorted)
+				 *
+				 * @return The move (board::PackedMove)
+				 */
+				board::PackedMove pick() {
+					int best = this->index;
+					for (int j = this->index + 1; j < this->moves.size(); j++)
+						if (this->scores[j] > this->scores[best])
+							best = j;
+					std::swap(this->moves[this->index], this->moves[best]);
+					std::swap(this->scores[this->index], this->scores[best]);
+					return this->moves[this->index++];
+				}
+
+			public:
+				/**
+				 * @brief Construct a new Move Picker object
+				 *
+				 * @param board The position (must not change while picking)
+				 * @param history The history of the quiet moves
+				 * @param first The move to try first (raw 0 if none)
+				 * @param killers The killer moves of the ply (raw 0 if none)
+				 * @param tactical_only If only the captures and promotions are given
+				 */
+				MovePicker(board::Board &board, const History &history, board::PackedMove first, const std::array<board::PackedMove, 2> &killers, bool tactical_only = false) : board(board), history(history), first(first), killers(killers), tactical_only(tactical_only) {}
+
+				/**
+				 * @brief Gets the next move
+				 *
+				 * @param move The move (output)
+				 * @return If there was a move left (bool)
+				 */
+				bool next(board::PackedMove &move) {
+					switch (this->stage) {
+						case first_stage:
+							this->stage = tactical_init;
+							if (this->first.raw() != 0 && (!this->tactical_only || is_tactical(this->board, this->first)) && this->board.is_legal_move(this->first)) {
+								move = this->first;
+								this->given++;
+								return true;
+							}
+							[[fallthrough]];
+						case tactical_init:
+							this->moves.clear();
+							this->index = 0;
+							this->board.generate_stage(this->moves, board::tactical_moves);
+							for (int i = 0; i < this->moves.size(); i++)
+								this->scores[i] = this->score_tactical(this->moves[i]);
+							this->stage = tactical_stage;
+							[[fallthrough]];
+						case tactical_stage:
+							while (this->index < this->moves.size()) {
+								move = this->pick();
+								if (move != this->first) {
+									this->given++;
+									return true;
+								}
+							}
+							if (this->tactical_only) {
+								this->stage = done_stage;
+								return false;
+							}
+							this->stage = killer_stage;
+							[[fallthrough]];
+						case killer_stage:
+							while (this->killer_index < 2) {
+								move = this->killers[this->killer_index++];
+								if (move.raw() != 0 && move != this->first && !is_tactical(this->board, move) && this->board.is_legal_move(move)) {
+									this->given++;
+									return true;
+								}
+							}
+							this->stage = quiet_init;
+							[[fallthrough]];
+						case quiet_init:
+							this->moves.clear();
+							this->index = 0;
+							this->board.generate_stage(this->moves, board::quiet_moves);
+							for (int i = 0; i < this->moves.size(); i++)
+								this->scores[i] = this->history[this->board.is_white_turn() ? 0 : 1][this->moves[i].from()][this->moves[i].to()];
+							this->stage = quiet_stage;
+							[[fallthrough]];
+						case quiet_stage:
+							while (this->index < this->moves.size()) {
+								move = this->pick();
+								if (move != this->first && move != this->killers[0] && move != this->killers[1]) {
+									this->given++;
+									return true;
+								}
+							}
+							this->stage = done_stage;
+							[[fallthrough]];
+						default:
+							return false;
+					}
+				}
+
+				/**
+				 * @brief Gets the number of moves given
+				 *
+				 * @return The number of moves (int)
+				 */
+				int get_given() const {
+					return this->given;
+				}
+		};
+
+		/**
+		 * @brief An iterative deepening alpha-beta (negamax) search with a principal
+		 * variation and a node and time budget
+		 *
+		 */
+		class Searcher {
+			private:
+				/**
+				 * @brief The position being searched (moves are made and unmade on it)
+				 */
+				board::Board board;
+				/**
+				 * @brief The transposition table (shared with the other searchers, optional)
+				 */
+				TranspositionTable *tt = nullptr;
+				/**
+				 * @brief The network evaluation following the moves of the search (optional,
+				 * the piece square evaluation is used without it)
+				 */
+				std::unique_ptr<nnue::Evaluator> evaluator;
+				/**
+				 * @brief The limits of the search
+				 */
+				Limits limits;
+				/**
+				 * @brief When the search started
+				 */
+				std::chrono::steady_clock::time_point start;
+				/**
+				 * @brief The number of nodes searched
+				 */
+				uint64_t nodes = 0;
+				/**
+				 * @brief The number of nodes searched, published every 1024 nodes for the
+				 * other threads
+				 */
+				std::atomic<uint64_t> published_nodes{0};
+				/**
+				 * @brief The number of transposition table lookups and hits
+				 */
+				uint64_t tt_probes = 0, tt_hits = 0;
+				/**
+				 * @brief The number of beta cutoffs, and of those made by the first move tried
+				 */
+				uint64_t cutoffs = 0, first_move_cutoffs = 0;
+				/**
+				 * @brief The last two quiet moves that caused a cutoff at each ply
+				 */
+				std::array<std::array<board::PackedMove, 2>, max_ply> killers{};
+				/**
+				 * @brief The history of the quiet moves
+				 */
+				History history{};
+				/**
+				 * @brief The history is halved when an entry reaches this (stays below the
+				 * scores of the killer moves)
+				 */
+				static constexpr int history_limit = 1 << 20;
+				/**
+				 * @brief If the search ran out of budget (the current depth is discarded)
+				 */
+				bool stopped = false;
+				/**
+				 * @brief The principal variations found at each ply (triangular table)
+				 */
+				std::array<std::array<board::PackedMove, max_ply>, max_ply> pv;
+				/**
+				 * @brief The length of the principal variation at each ply
+				 */
+				std::array<int, max_ply> pv_length{};
+				/**
+				 * @brief The principal variation of the last completed depth (searched first)
+				 */
+				std::vector<board::PackedMove> previous_pv;
+
+				/**
+				 * @brief Gets the time spent since the start of the search
+				 *
+				 * @return The time in milliseconds (int64_t)
+				 */
+				int64_t elapsed() const {
+					return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->start).count();
+				}
+
+				/**
+				 * @brief Counts a node and checks the budget (the clock is read every 1024
+				 * nodes)
+				 *
+				 * @return If the search must stop (bool)
+				 */
+				bool out_of_budget() {
+					this->nodes++;
+					if (this->stopped)
+						return true;
+					if (this->limits.nodes && this->nodes >= this->limits.nodes)
+						this->stopped = true;
+					else if ((this->nodes & 1023) == 0) {
+						this->published_nodes.store(this->nodes, std::memory_order_relaxed);
+						if (this->limits.stop && this->limits.stop->load(std::memory_order_relaxed))
+							this->stopped = true;
+						else if (this->limits.time && this->elapsed() >= this->limits.time)
+							this->stopped = true;
+					}
+					return this->stopped;
+				}
+
+				/**
+				 * @brief Plays a move on the searched position (and on the network
+				 * accumulators)
+				 *
+				 * @param move The move (legal)
+				 * @return The information to undo the move (board::UndoInfo)
+				 */
+				board::UndoInfo make_move(board::PackedMove move) {
+					board::UndoInfo undo = this->board.make_move(move);
+					if (this->evaluator)
+						this->evaluator->push(this->board, undo);
+					return undo;
+				}
+
+				/**
+				 * @brief Takes back the last move played with make_move
+				 *
+				 * @param undo The information returned by make_move
+				 */
+				void unmake_move(const board::UndoInfo &undo) {
+					this->board.unmake_move(undo);
+					if (this->evaluator)
+						this->evaluator->pop();
+				}
+
+				/**
+				 * @brief Evaluates the searched position (with the network if there is one)
+				 *
+				 * @return The score for the side to move (in centipawns) (int)
+				 */
+				int evaluate() const {
+					return this->evaluator ? this->evaluator->evaluate(this->board) : search::evaluate(this->board);
+				}
+
+				/**
+				 * @brief Remembers a quiet move that caused a cutoff (as a killer move of the
+				 * ply and in the history of its side)
+				 *
+				 * @param move The move
+				 * @param ply The ply of the move
+				 * @param depth The remaining depth (deeper cutoffs count more)
+				 */
+				void update_quiet(board::PackedMove move, int ply, int depth) {
+					if (move != this->killers[ply][0]) {
+						this->killers[ply][1] = this->killers[ply][0];
+						this->killers[ply][0] = move;
+					}
+					int &entry = this->history[this->board.is_white_turn() ? 0 : 1][move.from()][move.to()];
+					entry += depth * depth;
+					if (entry >= history_limit) {
+						for (auto &side : this->history)
+							for (auto &from : side)
+								for (int &value : from)
+									value /= 2;
+					}
+				}
+
+				/**
+				 * @brief Searches the captures and promotions until the position is quiet
+				 * (every evasion when in check, as standing pat is not an option there)
+				 *
+				 * @param alpha The lower bound
+				 * @param beta The upper bound
+				 * @param ply The distance to the root
+				 * @return The score for the side to move (int)
+				 */
+				int quiescence(int alpha, int beta, int ply) {
+					this->pv_length[ply] = 0;
+					if (this->out_of_budget())
+						return 0;
+					if (ply >= max_ply - 1)
+						return this->evaluate();
+					bool in_check = this->board.is_check(this->board.is_white_turn());
+					if (!in_check) {
+						int stand_pat = this->evaluate();
+						if (stand_pat >= beta)
+							return stand_pat;
+						alpha = std::max(alpha, stand_pat);
+					}
+					MovePicker picker(this->board, this->history, board::PackedMove{}, {}, !in_check);
+					board::PackedMove move;
+					while (picker.next(move)) {
+						board::UndoInfo undo = this->make_move(move);
+						int score = -this->quiescence(-beta, -alpha, ply + 1);
+						this->unmake_move(undo);
+						if (this->stopped)
+							return 0;
+						if (score >= beta)
+							return score;
+						alpha = std::max(alpha, score);
+					}
+					if (in_check && picker.get_given() == 0)
+						return -mate + ply;
+					return alpha;
+				}
+
+				/**
+				 * @brief Searches a position with alpha-beta pruning
+				 *
+				 * @param depth The remaining depth (in plies)
+				 * @param alpha The lower bound
+				 * @param beta The upper bound
+				 * @param ply The distance to the root
+				 * @param following If the moves from the root followed the previous
+				 * principal variation
+				 * @return The score for the side to move (int)
+				 */
+				int negamax(int depth, int alpha, int beta, int ply, bool following) {
+					this->pv_length[ply] = 0;
+					if (ply > 0) {
+						if (this->board.get_halfmove_clock() >= 100 || this->board.repetitions() >= 2 || this->board.insufficient_material())
+							return 0;
+						// A shorter mate was already found
+						alpha = std::max(alpha, -mate + ply);
+						beta = std::min(beta, mate - ply - 1);
+						if (alpha >= beta)
+							return alpha;
+					}
+					if (depth <= 0 || ply >= max_ply - 1)
+						return this->quiescence(alpha, beta, ply);
+					if (this->out_of_budget())
+						return 0;
+					uint64_t key = this->board.get_key();
+					board::PackedMove hash_move{};
+					if (this->tt) {
+						TTData entry;
+						this->tt_probes++;
+						if (this->tt->probe(key, ply, entry)) {
+							this->tt_hits++;
+							hash_move = entry.move;
+							if (ply > 0 && entry.depth >= depth && (entry.bound == exact_bound || (entry.bound == lower_bound && entry.score >= beta) || (entry.bound == upper_bound && entry.score <= alpha)))
+								return entry.score;
+						}
+					}
+					board::PackedMove first = following && ply < int(this->previous_pv.size()) ? this->previous_pv[ply] : hash_move;
+					MovePicker picker(this->board, this->history, first, this->killers[ply]);
+					int original_alpha = alpha;
+					int best = -infinity;
+					board::PackedMove best_move{};
+					board::PackedMove move;
+					while (picker.next(move)) {
+						board::UndoInfo undo = this->make_move(move);
+						int score = -this->negamax(depth - 1, -beta, -alpha, ply + 1, following && move == first);
+						this->unmake_move(undo);
+						if (this->stopped)
+							return 0;
+						if (score > best) {
+							best = score;
+							best_move = move;
+						}
+						if (score > alpha) {
+							alpha = score;
+							this->pv[ply][0] = move;
+							for (int j = 0; j < this->pv_length[ply + 1]; j++)
+								this->pv[ply][j + 1] = this->pv[ply + 1][j];
+							this->pv_length[ply] = this->pv_length[ply + 1] + 1;
+						}
+						if (alpha >= beta) {
+							this->cutoffs++;
+							this->first_move_cutoffs += picker.get_given() == 1;
+							if (!is_tactical(this->board, move))
+								this->update_quiet(move, ply, depth);
+							break;
+						}
+					}
+					if (picker.get_given() == 0)
+						return this->board.is_check(this->board.is_white_turn()) ? -mate + ply : 0;
+					if (this->tt)
+						this->tt->store(key, ply, best_move, best, depth, best >= beta ? lower_bound : best > original_alpha ? exact_bound : upper_bound);
+					return best;
+				}
+
+				/**
+				 * @brief Completes a principal variation cut by transposition table hits
+				 * with the moves of the table
+				 *
+				 * @param pv The principal variation
+				 * @param depth The length to reach
+				 */
+				void extend_pv(std::vector<board::PackedMove> &pv, int depth) {
+					if (!this->tt)
+						return;
+					std::vector<board::UndoInfo> undos;
+					for (auto move : pv)
+						undos.push_back(this->board.make_move(move));
+					TTData entry;
+					while (int(pv.size()) < depth && this->board.repetitions() < 2 && this->tt->probe(this->board.get_key(), 0, entry) && entry.move.raw() != 0) {
+						bool legal = false;
+						for (auto move : this->board.generate_moves(this->board.is_white_turn()))
+							legal = legal || move == entry.move;
+						if (!legal)
+							break;
+						pv.push_back(entry.move);
+						undos.push_back(this->board.make_move(entry.move));
+					}
+					for (size_t i = undos.size(); i-- > 0;)
+						this->board.unmake_move(undos[i]);
+				}
+
+			public:
+				/**
+				 * @brief Construct a new Searcher object
+				 *
+				 * @param board The position to search (copied)
+				 * @param tt The transposition table (optional, the caller starts each search
+				 * with TranspositionTable::new_search)
+				 * @param network The network to evaluate with (optional, must outlive the
+				 * searcher)
+				 */
+				Searcher(const board::Board &board, TranspositionTable *tt = nullptr, const nnue::Network *network = nullptr) : board(board), tt(tt) {
+					if (network)
+						this->evaluator = std::make_unique<nnue::Evaluator>(*network);
+				}
+
+				/**
+				 * @brief Gets the number of nodes searched (thread safe, up to 1023 nodes
+				 * late while searching)
+				 *
+				 * @return The number of nodes (uint64_t)
+				 */
+				uint64_t get_nodes() const {
+					return this->published_nodes.load(std::memory_order_relaxed);
+				}
+
+				/**
+				 * @brief Searches the position depth after depth until a limit is reached
+				 *
+				 * @param limits The limits of the search
+				 * @param report Called after every completed depth (optional)
+				 * @param helper The index of a helper thread of a parallel search (0 for the
+				 * main thread, odd helpers start one depth deeper so that the threads do not
+				 * all search the same depth)
+				 * @return The result of the last completed depth (Result)
+				 */
+				Result think(const Limits &limits, const std::function<void(const Result &)> &report = nullptr, int helper = 0) {
+					this->limits = limits;
+					this->start = std::chrono::steady_clock::now();
+					this->nodes = 0;
+					this->published_nodes = 0;
+					this->tt_probes = 0;
+					this->tt_hits = 0;
+					this->cutoffs = 0;
+					this->first_move_cutoffs = 0;
+					this->killers = {};
+					this->stopped = false;
+					this->previous_pv.clear();
+					if (this->evaluator)
+						this->evaluator->reset(this->board);
+					Result result;
+					board::MoveList moves = this->board.generate_moves(this->board.is_white_turn());
+					if (moves.empty())
+						return result;
+					result.best = moves[0];
+					int max_depth = limits.depth > 0 ? std::min(limits.depth, max_ply - 1) : max_ply - 1;
+					for (int depth = 1 + (helper & 1); depth <= max_depth; depth++) {
+						int score = this->negamax(depth, -infinity, infinity, 0, true);
+						if (this->stopped)
+							break;
+						result.score = score;
+						result.depth = depth;
+						result.pv.assign(this->pv[0].begin(), this->pv[0].begin() + this->pv_length[0]);
+						if (report)
+							this->extend_pv(result.pv, depth);
+						if (!result.pv.empty())
+							result.best = result.pv[0];
+						result.nodes = this->nodes;
+						result.time = this->elapsed();
+						result.tt_probes = this->tt_probes;
+						result.tt_hits = this->tt_hits;
+						result.cutoffs = this->cutoffs;
+						result.first_move_cutoffs = this->first_move_cutoffs;
+						this->previous_pv = result.pv;
+						if (report)
+							report(result);
+						// Only one move, or a mate that can not get shorter
+						if (moves.size() == 1 || (std::abs(score) > mate_bound && mate - std::abs(score) <= depth))
+							break;
+					}
+					result.nodes = this->nodes;
+					result.time = this->elapsed();
+					result.tt_probes = this->tt_probes;
+					result.tt_hits = this->tt_hits;
+					result.cutoffs = this->cutoffs;
+					result.first_move_cutoffs = this->first_move_cutoffs;
+					this->published_nodes = this->nodes;
+					return result;
+				}
+		};
+
+		/**
+		 * @brief Searches a position on several threads (Lazy SMP): every thread
+		 * searches the whole tree on its own copy of the board and they share their
+		 * results through the transposition table. The main thread reports and gives
+		 * the result, the helpers stop when it does.
+		 *
+		 * @param board The position to search
+		 * @param tt The transposition table (shared by the threads, the caller starts
+		 * each search with TranspositionTable::new_search)
+		 * @param threads The number of threads (at least 1)
+		 * @param limits The limits of the search (the node limit applies to each
+		 * thread)
+		 * @param report Called after every depth completed by the main thread, with
+		 * the nodes of all the threads (optional)
+		 * @param network The network to evaluate with (optional)
+		 * @return The result of the main thread, with the nodes of all the threads
+		 * (Result)
+		 */
+		Result think_parallel(const board::Board &board, TranspositionTable *tt, int threads, const Limits &limits, const std::function<void(const Result &)> &report = nullptr, const nnue::Network *network = nullptr) {
+			std::vector<std::unique_ptr<Searcher>> searchers;
+			for (int i = 0; i < std::max(1, threads); i++)
+				searchers.emplace_back(new Searcher(board, tt, network));
+			std::atomic<bool> helpers_stop{false};
+			Limits helper_limits = limits;
+			helper_limits.stop = &helpers_stop;
+			std::vector<std::thread> helpers;
+			for (size_t i = 1; i < searchers.size(); i++)
+				helpers.emplace_back([&, i]() { searchers[i]->think(helper_limits, nullptr, int(i)); });
+
+			auto total_nodes = [&](uint64_t main_nodes) {
+				for (size_t i = 1; i < searchers.size(); i++)
+					main_nodes += searchers[i]->get_nodes();
+				return main_nodes;
+			};
+			Result result = searchers[0]->think(limits, [&](const Result &partial) {
+				if (!report)
+					return;
+				Result total = partial;
+				total.nodes = total_nodes(partial.nodes);
+				report(total);
+			});
+			helpers_stop = true;
+			for (auto &helper : helpers)
+				helper.join();
+			result.nodes = total_nodes(result.nodes);
+			return result;
+		}
+	} // namespace search
+} // namespace PlayeChessEngine
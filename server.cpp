@@ -0,0 +1,498 @@
+#include <iostream>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "game_host.cpp"
+
+/**
+ * @brief A client connection (the responses are written in the order of the
+ * requests, even when the games are on different workers)
+ */
+struct Connection {
+    int fd = -1;
+    uint32_t id = 0;
+    /**
+     * @brief The received bytes not yet parsed (an incomplete line)
+     */
+    std::string input;
+    /**
+     * @brief The bytes not yet written
+     */
+    std::string output;
+    /**
+     * @brief The sequence number of the next request
+     */
+    uint32_t next_request = 0;
+    /**
+     * @brief The sequence number of the next response to write
+     */
+    uint32_t next_response = 0;
+    /**
+     * @brief The responses waiting for an earlier one, by sequence number
+     */
+    std::map<uint32_t, std::string> waiting;
+    /**
+     * @brief The games created by the connection (the only ones it can use, closed
+     * when it disconnects)
+     */
+    std::unordered_set<uint32_t> games;
+    /**
+     * @brief The epoll events watched (no EPOLLIN while too much output is
+     * pending, EPOLLOUT while the socket is full)
+     */
+    uint32_t watched = EPOLLIN;
+    /**
+     * @brief If the connection is in the list of connections to write
+     */
+    bool dirty = false;
+};
+
+/**
+ * @brief A line-based server running games on a GameHost with an epoll event
+ * loop (one line per request, one line per response, in order)
+ *
+ * Requests:
+ *  new [fen]          -> ok <game>
+ *  move <game> <move> -> ok <result> <w|b>
+ *  moves <game>       -> ok <moves...>
+ *  status <game>      -> ok <result> <fen>
+ *  close <game>       -> ok
+ * Errors are answered with "error <reason>". A connection can only use the games
+ * it created, which are closed when it disconnects. A line longer than
+ * line_limit closes the connection.
+ */
+class Server {
+    private:
+        /**
+         * @brief Stop reading a connection while this many bytes are not written
+         */
+        static constexpr size_t output_limit = 1 << 20;
+        /**
+         * @brief Stop reading a connection while this many bytes are not parsed
+         */
+        static constexpr size_t input_limit = 1 << 20;
+        /**
+         * @brief The connection is closed when a line is longer than this
+         */
+        static constexpr size_t line_limit = 4096;
+
+        int epoll_fd = -1;
+        int listen_fd = -1;
+        /**
+         * @brief Written by the workers of the host when responses are completed
+         */
+        int event_fd = -1;
+        PlayeChessEngine::GameHost host;
+        std::unordered_map<uint32_t, Connection> connections;
+        /**
+         * @brief The connection id of each file descriptor
+         */
+        std::unordered_map<int, uint32_t> by_fd;
+        uint32_t next_connection = 1;
+        /**
+         * @brief The connections with responses to write
+         */
+        std::vector<uint32_t> dirty;
+        std::vector<PlayeChessEngine::HostRequest> requests;
+        std::vector<PlayeChessEngine::HostResponse> responses;
+
+        /**
+         * @brief Makes a file descriptor non blocking
+         *
+         * @param fd The file descriptor
+         */
+        static void set_non_blocking(int fd) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+
+        /**
+         * @brief Parses a game id
+         *
+         * @param text The text
+         * @param game The game (output)
+         * @return If the text is a number that fits in 32 bits (bool)
+         */
+        static bool parse_game(std::string_view text, uint32_t &game) {
+            if (text.empty() || text.size() > 10)
+                return false;
+            uint64_t number = 0;
+            for (char c : text) {
+                if (c < '0' || c > '9')
+                    return false;
+                number = number * 10 + uint64_t(c - '0');
+            }
+            if (number > UINT32_MAX)
+                return false;
+            game = uint32_t(number);
+            return true;
+        }
+
+        /**
+         * @brief Stores the response of a request and writes the responses that are
+         * now in order
+         *
+         * @param connection The connection
+         * @param sequence The sequence number of the request
+         * @param line The response (without the new line)
+         */
+        void respond(Connection &connection, uint32_t sequence, std::string line) {
+            if (sequence != connection.next_response) {
+                connection.waiting.emplace(sequence, std::move(line));
+                return;
+            }
+            connection.output += line;
+            connection.output += '\n';
+            connection.next_response++;
+            if (!connection.dirty) {
+                connection.dirty = true;
+                this->dirty.push_back(connection.id);
+            }
+            for (auto next = connection.waiting.begin(); next != connection.waiting.end() && next->first == connection.next_response; next = connection.waiting.erase(next)) {
+                connection.output += next->second;
+                connection.output += '\n';
+                connection.next_response++;
+            }
+        }
+
+        /**
+         * @brief Parses a request line and queues it for the host (or answers it if
+         * it is invalid)
+         *
+         * @param connection The connection
+         * @param line The line
+         */
+        void parse(Connection &connection, std::string_view line) {
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            uint32_t sequence = connection.next_request++;
+            size_t space = line.find(' ');
+            std::string_view command = line.substr(0, space);
+            std::string_view rest = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+            PlayeChessEngine::HostRequest request;
+            request.tag = (uint64_t(connection.id) << 32) | sequence;
+            if (command == "new") {
+                request.type = PlayeChessEngine::new_game;
+                request.game = this->host.create_game_id();
+                connection.games.insert(request.game);
+                request.argument = std::string(rest);
+                this->requests.push_back(std::move(request));
+                return;
+            }
+            space = rest.find(' ');
+            std::string_view game = rest.substr(0, space);
+            std::string_view argument = space == std::string_view::npos ? std::string_view() : rest.substr(space + 1);
+            if (command == "move")
+                request.type = PlayeChessEngine::play_move;
+            else if (command == "moves")
+                request.type = PlayeChessEngine::legal_moves;
+            else if (command == "status")
+                request.type = PlayeChessEngine::game_status;
+            else if (command == "close")
+                request.type = PlayeChessEngine::close_game;
+            else
+                return this->respond(connection, sequence, "error unknown command");
+            if (!parse_game(game, request.game) || !connection.games.count(request.game))
+                return this->respond(connection, sequence, "error invalid game");
+            if (request.type == PlayeChessEngine::close_game)
+                connection.games.erase(request.game);
+            request.argument = std::string(argument);
+            this->requests.push_back(std::move(request));
+        }
+
+        /**
+         * @brief Formats the response of the host to a request
+         *
+         * @param response The response
+         * @return The line (std::string)
+         */
+        static std::string format(const PlayeChessEngine::HostResponse &response) {
+            if (!response.ok)
+                return "error " + response.data;
+            switch (response.type) {
+                case PlayeChessEngine::new_game:
+                    return "ok " + std::to_string(response.game);
+                case PlayeChessEngine::play_move:
+                    return std::string("ok ") + PlayeChessEngine::result_name(response.result) + (response.white_turn ? " w" : " b");
+                case PlayeChessEngine::legal_moves:
+                    return response.data.empty() ? "ok" : "ok " + response.data;
+                case PlayeChessEngine::game_status:
+                    return std::string("ok ") + PlayeChessEngine::result_name(response.result) + " " + response.data;
+                default:
+                    return "ok";
+            }
+        }
+
+        /**
+         * @brief Accepts the pending connections
+         */
+        void accept_connections() {
+            while (true) {
+                int fd = accept(this->listen_fd, nullptr, nullptr);
+                if (fd < 0)
+                    return;
+                set_non_blocking(fd);
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                Connection &connection = this->connections[this->next_connection];
+                connection.fd = fd;
+                connection.id = this->next_connection++;
+                this->by_fd[fd] = connection.id;
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.fd = fd;
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+            }
+        }
+
+        /**
+         * @brief Closes a connection (its pending responses are dropped and its games
+         * are closed)
+         *
+         * @param connection The connection
+         */
+        void close_connection(Connection &connection) {
+            for (uint32_t game : connection.games) {
+                PlayeChessEngine::HostRequest request;
+                request.tag = uint64_t(connection.id) << 32;
+                request.type = PlayeChessEngine::close_game;
+                request.game = game;
+                this->requests.push_back(std::move(request));
+            }
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+            close(connection.fd);
+            this->by_fd.erase(connection.fd);
+            this->connections.erase(connection.id);
+        }
+
+        /**
+         * @brief Reads the requests of a connection
+         *
+         * @param connection The connection
+         * @return If the connection is still open (bool)
+         */
+        bool read_requests(Connection &connection) {
+            char buffer[16384];
+            while (connection.output.size() < output_limit && connection.input.size() < input_limit) {
+                ssize_t count = recv(connection.fd, buffer, sizeof(buffer), 0);
+                if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    this->close_connection(connection);
+                    return false;
+                }
+                if (count < 0)
+                    break;
+                connection.input.append(buffer, size_t(count));
+            }
+            size_t start = 0;
+            for (size_t end; (end = connection.input.find('\n', start)) != std::string::npos; start = end + 1)
+                this->parse(connection, std::string_view(connection.input).substr(start, end - start));
+            connection.input.erase(0, start);
+            if (connection.input.size() > line_limit) {
+                this->close_connection(connection);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Writes the pending responses of a connection (and updates the
+         * watched events)
+         *
+         * @param connection The connection
+         */
+        void write_responses(Connection &connection) {
+            size_t written = 0;
+            while (written < connection.output.size()) {
+                ssize_t count = send(connection.fd, connection.output.data() + written, connection.output.size() - written, MSG_NOSIGNAL);
+                if (count < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        break;
+                    if (errno == EINTR)
+                        continue;
+                    return this->close_connection(connection);
+                }
+                written += size_t(count);
+            }
+            connection.output.erase(0, written);
+            uint32_t watched = (connection.output.size() < output_limit ? uint32_t(EPOLLIN) : 0) | (connection.output.empty() ? 0 : uint32_t(EPOLLOUT));
+            if (watched != connection.watched) {
+                epoll_event event{};
+                event.events = watched;
+                event.data.fd = connection.fd;
+                epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+                connection.watched = watched;
+            }
+        }
+
+        /**
+         * @brief Collects the completed responses of the host (a game that could not
+         * be created is no longer owned by its connection)
+         */
+        void collect() {
+            uint64_t value;
+            while (read(this->event_fd, &value, sizeof(value)) > 0) {
+            }
+            this->host.complete(this->responses, false);
+            for (auto &response : this->responses) {
+                auto connection = this->connections.find(uint32_t(response.tag >> 32));
+                if (connection == this->connections.end())
+                    continue;
+                if (response.type == PlayeChessEngine::new_game && !response.ok)
+                    connection->second.games.erase(response.game);
+                this->respond(connection->second, uint32_t(response.tag), format(response));
+            }
+            this->responses.clear();
+        }
+
+    public:
+        /**
+         * @brief Construct a new Server object
+         *
+         * @param threads The number of workers of the host
+         */
+        Server(int threads) : host(threads, [this]() {
+            uint64_t one = 1;
+            ssize_t ignored = write(this->event_fd, &one, sizeof(one));
+            (void)ignored;
+        }) {
+            this->epoll_fd = epoll_create1(0);
+            this->event_fd = eventfd(0, EFD_NONBLOCK);
+        }
+
+        /**
+         * @brief Listens on a TCP port of the loopback interface
+         *
+         * @param port The port
+         * @return If the socket is listening (bool)
+         */
+        bool listen_tcp(int port) {
+            this->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+            int one = 1;
+            setsockopt(this->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(uint16_t(port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            return bind(this->listen_fd, (sockaddr *)&address, sizeof(address)) == 0 && listen(this->listen_fd, SOMAXCONN) == 0;
+        }
+
+        /**
+         * @brief Listens on a Unix socket (an existing file at the path is replaced)
+         *
+         * @param path The path of the socket
+         * @return If the socket is listening (bool)
+         */
+        bool listen_unix(const std::string &path) {
+            this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path))
+                return false;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            unlink(path.c_str());
+            return bind(this->listen_fd, (sockaddr *)&address, sizeof(address)) == 0 && listen(this->listen_fd, SOMAXCONN) == 0;
+        }
+
+        /**
+         * @brief Runs the event loop (forever)
+         */
+        void run() {
+            set_non_blocking(this->listen_fd);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = this->listen_fd;
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->listen_fd, &event);
+            event.data.fd = this->event_fd;
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->event_fd, &event);
+
+            std::vector<epoll_event> events(256);
+            while (true) {
+                int count = epoll_wait(this->epoll_fd, events.data(), int(events.size()), -1);
+                if (count < 0 && errno != EINTR)
+                    return;
+                for (int i = 0; i < count; i++) {
+                    int fd = events[i].data.fd;
+                    if (fd == this->listen_fd) {
+                        this->accept_connections();
+                        continue;
+                    }
+                    if (fd == this->event_fd) {
+                        this->collect();
+                        continue;
+                    }
+                    auto id = this->by_fd.find(fd);
+                    if (id == this->by_fd.end())
+                        continue;
+                    Connection &connection = this->connections[id->second];
+                    if ((events[i].events & (EPOLLERR | EPOLLHUP)) && !(events[i].events & EPOLLIN)) {
+                        this->close_connection(connection);
+                        continue;
+                    }
+                    if ((events[i].events & EPOLLIN) && !this->read_requests(connection))
+                        continue;
+                    if ((events[i].events & EPOLLOUT) && !connection.dirty) {
+                        connection.dirty = true;
+                        this->dirty.push_back(connection.id);
+                    }
+                }
+                // All the requests read in this iteration go to the host in one batch
+                if (!this->requests.empty())
+                    this->host.submit(this->requests);
+                for (uint32_t id : this->dirty) {
+                    auto connection = this->connections.find(id);
+                    if (connection == this->connections.end())
+                        continue;
+                    connection->second.dirty = false;
+                    this->write_responses(connection->second);
+                }
+                this->dirty.clear();
+                // The games of the connections closed while writing
+                if (!this->requests.empty())
+                    this->host.submit(this->requests);
+            }
+        }
+};
+
+int main(int argc, char *argv[]) {
+    int port = 7878, threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string path;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--port")
+            port = std::stoi(argv[i + 1]);
+        else if (arg == "--unix")
+            path = argv[i + 1];
+        else if (arg == "--threads")
+            threads = std::max(1, std::stoi(argv[i + 1]));
+        else {
+            std::cout << "Usage: server [--port n | --unix path] [--threads n]" << std::endl;
+            return 1;
+        }
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    Server server(threads);
+    if (!(path.empty() ? server.listen_tcp(port) : server.listen_unix(path))) {
+        std::cerr << "Cannot listen on " << (path.empty() ? "port " + std::to_string(port) : path) << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "Listening on " << (path.empty() ? "127.0.0.1:" + std::to_string(port) : path) << " with " << threads << " worker(s)" << std::endl;
+    server.run();
+    return 0;
+}
@@ -0,0 +1,372 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "search.cpp"
+
+/**
+ * @brief The limits of a "go" command (0 when not given)
+ */
+struct GoLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t movetime = 0;
+    int64_t wtime = 0;
+    int64_t btime = 0;
+    int64_t winc = 0;
+    int64_t binc = 0;
+    int movestogo = 0;
+    bool infinite = false;
+};
+
+/**
+ * @brief A UCI front end (https://www.shredderchess.com/chess-features/uci-universal-chess-interface.html)
+ * keeping one game: "position" only plays or takes back the moves that changed
+ * since the last one
+ */
+class Uci {
+    private:
+        const std::string start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+        /**
+         * @brief The game (its first position is position_fen)
+         */
+        PlayeChessEngine::GameSession session;
+        std::string position_fen = start;
+        /**
+         * @brief The moves of the last "position" command, as sent
+         */
+        std::vector<std::string> position_moves;
+
+        /**
+         * @brief The transposition table (the "Hash" option, in MB)
+         */
+        PlayeChessEngine::search::TranspositionTable tt{16};
+        /**
+         * @brief The number of search threads (the "Threads" option)
+         */
+        int threads = 1;
+        /**
+         * @brief The network to evaluate with (the "EvalFile" option, the piece square
+         * evaluation is used without it)
+         */
+        std::unique_ptr<PlayeChessEngine::nnue::Network> network;
+
+        std::thread thinker;
+        std::atomic<bool> stopping{false};
+        /**
+         * @brief Where the lines for the GUI are written
+         */
+        std::ostream &output;
+        std::mutex output_mutex;
+
+        /**
+         * @brief Writes a line to the GUI (thread safe)
+         *
+         * @param line The line
+         */
+        void send(const std::string &line) {
+            std::lock_guard<std::mutex> lock(this->output_mutex);
+            this->output << line << std::endl;
+        }
+
+        /**
+         * @brief Waits for the search (if any) to send its bestmove
+         */
+        void wait() {
+            if (this->thinker.joinable())
+                this->thinker.join();
+            this->stopping = false;
+        }
+
+        /**
+         * @brief Stops the search (if any) and waits for its bestmove
+         */
+        void stop() {
+            this->stopping = true;
+            this->wait();
+        }
+
+        /**
+         * @brief Handles "position [startpos | fen <fen>] [moves <moves>]"
+         *
+         * @param words The words of the command
+         */
+        void position(const std::vector<std::string> &words) {
+            size_t i = 1;
+            std::string fen;
+            if (i < words.size() && words[i] == "startpos") {
+                fen = start;
+                i++;
+            } else if (i < words.size() && words[i] == "fen") {
+                for (i++; i < words.size() && words[i] != "moves"; i++)
+                    fen += (fen.empty() ? "" : " ") + words[i];
+            } else
+                return;
+            std::vector<std::string> moves;
+            if (i < words.size() && words[i] == "moves")
+                moves.assign(words.begin() + i + 1, words.end());
+
+            size_t common = 0;
+            if (fen == this->position_fen) {
+                while (common < moves.size() && common < this->position_moves.size() && moves[common] == this->position_moves[common])
+                    common++;
+                while (this->position_moves.size() > common) {
+                    this->session.undo_move();
+                    this->position_moves.pop_back();
+                }
+            } else {
+                try {
+                    this->session = PlayeChessEngine::GameSession(fen);
+                } catch (const std::invalid_argument &error) {
+                    this->send(std::string("info string ") + error.what());
+                    return;
+                }
+                this->position_fen = fen;
+                this->position_moves.clear();
+            }
+            for (size_t m = common; m < moves.size(); m++) {
+                if (!this->session.apply_move(moves[m])) {
+                    this->send("info string illegal move " + moves[m]);
+                    return;
+                }
+                this->position_moves.push_back(moves[m]);
+            }
+        }
+
+        /**
+         * @brief Handles "setoption name <name> value <value>"
+         *
+         * @param words The words of the command
+         */
+        void set_option(const std::vector<std::string> &words) {
+            if (words.size() < 5 || words[1] != "name" || words[3] != "value")
+                return;
+            if (words[2] == "Hash")
+                this->tt.resize(std::clamp<size_t>(std::stoul(words[4]), 1, 65536));
+            else if (words[2] == "Threads")
+                this->threads = std::clamp(std::stoi(words[4]), 1, 256);
+            else if (words[2] == "EvalFile") {
+                std::string path;
+                for (size_t i = 4; i < words.size(); i++)
+                    path += (path.empty() ? "" : " ") + words[i];
+                // The scores of the table come from the previous evaluation
+                this->tt.clear();
+                this->network.reset();
+                if (path == "<empty>")
+                    return;
+                try {
+                    this->network = std::make_unique<PlayeChessEngine::nnue::Network>(path);
+                    this->send("info string loaded " + path + " (" + PlayeChessEngine::nnue::best_kernel()->name + ")");
+                } catch (const std::invalid_argument &error) {
+                    this->send(std::string("info string ") + error.what());
+                }
+            }
+        }
+
+        /**
+         * @brief Handles "go [depth n] [nodes n] [movetime ms] [wtime ms] [btime ms]
+         * [winc ms] [binc ms] [movestogo n] [infinite]"
+         *
+         * @param words The words of the command
+         */
+        void go(const std::vector<std::string> &words) {
+            GoLimits limits;
+            for (size_t i = 1; i < words.size(); i++) {
+                const std::string &word = words[i];
+                bool has_value = i + 1 < words.size();
+                if (word == "infinite")
+                    limits.infinite = true;
+                else if (!has_value)
+                    break;
+                else if (word == "depth")
+                    limits.depth = std::stoi(words[++i]);
+                else if (word == "nodes")
+                    limits.nodes = std::stoull(words[++i]);
+                else if (word == "movetime")
+                    limits.movetime = std::stoll(words[++i]);
+                else if (word == "wtime")
+                    limits.wtime = std::stoll(words[++i]);
+                else if (word == "btime")
+                    limits.btime = std::stoll(words[++i]);
+                else if (word == "winc")
+                    limits.winc = std::stoll(words[++i]);
+                else if (word == "binc")
+                    limits.binc = std::stoll(words[++i]);
+                else if (word == "movestogo")
+                    limits.movestogo = std::stoi(words[++i]);
+            }
+            this->thinker = std::thread([this, limits]() { this->think(limits); });
+        }
+
+        /**
+         * @brief Gets the time to spend on a move
+         *
+         * @param limits The limits of the go command
+         * @return The time in milliseconds (0 if there is no time limit) (int64_t)
+         */
+        int64_t budget(const GoLimits &limits) {
+            if (limits.infinite)
+                return 0;
+            if (limits.movetime > 0)
+                return limits.movetime;
+            bool white = this->session.is_white_turn();
+            int64_t time = white ? limits.wtime : limits.btime;
+            int64_t increment = white ? limits.winc : limits.binc;
+            if (time <= 0)
+                return 0;
+            int moves = limits.movestogo > 0 ? std::min(limits.movestogo, 40) : 30;
+            int64_t budget = time / moves + increment * 3 / 4;
+            return std::max<int64_t>(1, std::min(budget, time - std::min<int64_t>(time / 2, 50)));
+        }
+
+        /**
+         * @brief Looks for the move to play and sends it (runs on the thinker thread)
+         *
+         * @param limits The limits of the go command
+         */
+        void think(GoLimits limits) {
+            PlayeChessEngine::search::Limits search_limits;
+            search_limits.depth = limits.depth;
+            search_limits.nodes = limits.nodes;
+            search_limits.time = this->budget(limits);
+            search_limits.stop = &this->stopping;
+            this->tt.new_search();
+            auto result = PlayeChessEngine::search::think_parallel(this->session.get_board(), &this->tt, this->threads, search_limits, [this](const PlayeChessEngine::search::Result &result) {
+                std::string line = "info depth " + std::to_string(result.depth) + " score " + result.uci_score() + " nodes " + std::to_string(result.nodes) + " nps " + std::to_string(result.nodes * 1000 / std::max<int64_t>(1, result.time)) + " time " + std::to_string(result.time) + " hashfull " + std::to_string(this->tt.hashfull()) + " pv";
+                for (auto move : result.pv)
+                    line += " " + move.notation();
+                this->send(line);
+            }, this->network.get());
+            if (result.tt_probes)
+                this->send("info string hash hits " + std::to_string(result.tt_hits * 100 / result.tt_probes) + "% of " + std::to_string(result.tt_probes) + " probes");
+            if (result.cutoffs)
+                this->send("info string first move cutoffs " + std::to_string(result.first_move_cutoffs * 100 / result.cutoffs) + "% of " + std::to_string(result.cutoffs) + " cutoffs");
+            // With "go infinite" the move is only sent after "stop"
+            while (limits.infinite && !this->stopping)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            this->send("bestmove " + (result.best.raw() == 0 ? std::string("0000") : result.best.notation()));
+        }
+
+        /**
+         * @brief Handles a command
+         *
+         * @param words The words of the command (the command first)
+         */
+        void handle(const std::vector<std::string> &words) {
+            const std::string &command = words[0];
+            if (command == "uci") {
+                this->send("id name PCE");
+                this->send("id author playeChess");
+                this->send("option name Hash type spin default 16 min 1 max 65536");
+                this->send("option name Threads type spin default 1 min 1 max 256");
+                this->send("option name EvalFile type string default <empty>");
+                this->send("uciok");
+            } else if (command == "isready")
+                this->send("readyok");
+            else if (command == "ucinewgame") {
+                this->wait();
+                this->tt.clear();
+                this->session = PlayeChessEngine::GameSession(start);
+                this->position_fen = start;
+                this->position_moves.clear();
+            } else if (command == "setoption") {
+                this->wait();
+                this->set_option(words);
+            } else if (command == "position") {
+                this->wait();
+                this->position(words);
+            } else if (command == "go") {
+                this->wait();
+                this->go(words);
+            } else if (command == "stop" || command == "quit")
+                this->stop();
+            else if (command == "d")
+                this->send(this->session.fen());
+        }
+
+    public:
+        /**
+         * @brief Construct a new Uci object
+         *
+         * @param output Where the lines for the GUI are written
+         */
+        Uci(std::ostream &output = std::cout) : output(output) {}
+
+        ~Uci() {
+            this->stop();
+        }
+
+        /**
+         * @brief Reads the commands of the GUI until "quit" or the end of the input
+         *
+         * @param input Where the commands are read
+         */
+        void loop(std::istream &input = std::cin) {
+            std::string line;
+            while (std::getline(input, line)) {
+                std::istringstream stream(line);
+                std::vector<std::string> words;
+                for (std::string word; stream >> word;)
+                    words.push_back(word);
+                if (words.empty())
+                    continue;
+                try {
+                    this->handle(words);
+                } catch (const std::exception &) {
+                    this->send("info string invalid command: " + line);
+                }
+                if (words[0] == "quit")
+                    break;
+            }
+        }
+};
+
+/**
+ * @brief Checks that "position" rejects a move of the side not on turn and keeps
+ * the moves before it
+ *
+ * @return If every check passed (bool)
+ */
+bool check() {
+    struct Case {
+        std::string command;
+        std::string expected;
+        bool illegal;
+    };
+    const std::vector<Case> cases = {
+        {"position startpos moves e7e5", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", true},
+        {"position startpos moves e2e4 d2d4", "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1", true},
+        {"position startpos moves g1f3 g8f6", "rnbqkb1r/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKB1R w KQkq - 2 2", false},
+    };
+    bool ok = true;
+    for (const Case &test : cases) {
+        std::ostringstream output;
+        std::istringstream input(test.command + "\nd\n");
+        {
+            Uci uci(output);
+            uci.loop(input);
+        }
+        std::string text = output.str();
+        bool passed = text.size() > test.expected.size() && text.compare(text.size() - test.expected.size() - 1, test.expected.size(), test.expected) == 0;
+        passed = passed && (text.find("info string illegal move") != std::string::npos) == test.illegal;
+        ok = ok && passed;
+        std::cout << (passed ? "[OK]   " : "[FAIL] ") << test.command << " -> " << test.expected << std::endl;
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--check")
+        return check() ? 0 : 1;
+    std::ios::sync_with_stdio(false);
+    Uci uci;
+    uci.loop();
+    return 0;
+}